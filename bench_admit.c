@@ -0,0 +1,83 @@
+/**
+  @brief Benchmark of admission control on an overloaded queue.
+
+          ./bench_admit [jobs] [load percent] [capacity] [seed]
+
+  Generates jobs on demand, with bursts uniform in [1, 19] and random
+  inter-arrival times at the given load, and runs them through FCFS and
+  SJF with a ready queue of capacity jobs under each drop policy. The
+  jobs are never stored, so the memory is the queue whatever the number
+  of jobs. Prints the jobs per second of each run, the drop rate, the
+  goodput and the wait distribution of the admitted jobs, and the maximum
+  resident size of the process. The arrivals are int: the number of jobs
+  is limited so that the last one arrives by INT_MAX even if every
+  inter-arrival time is the longest, which also keeps the IDs in an int.
+*/
+
+#include "scheduling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+
+typedef struct {
+  long long num;
+  long long next;
+  int arrival;
+  int load;
+  unsigned int seed;
+} generator;
+
+static double now_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// mean burst 10, mean inter-arrival 1000 / load, uniform in [0, 2000 / load]
+static int generator_next(void *ctx, int *id, int *arrival, int *burst) {
+  generator *gen = (generator*) ctx;
+  if (gen->next == gen->num)
+    return 0;
+  gen->arrival += rand_r(&gen->seed) % (2000 / gen->load + 1);
+  *id = (int) ++gen->next;
+  *arrival = gen->arrival;
+  *burst = 1 + rand_r(&gen->seed) % 19;
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  long long num = argc > 1 ? atoll(argv[1]) : 10000000;
+  int load = argc > 2 ? atoi(argv[2]) : 150;
+  int capacity = argc > 3 ? atoi(argv[3]) : 64;
+  unsigned int seed = argc > 4 ? (unsigned int) atoi(argv[4]) : 1;
+  if (num < 1 || load < 1 || load > 2000 || capacity < 1 ||
+      num > 2147483647LL / (2000 / load)) {
+    fprintf(stderr, "usage: %s [jobs] [load percent, 1 to 2000] [capacity] [seed]\n"
+                    "the arrivals must fit in an int\n", argv[0]);
+    return 1;
+  }
+  char *policies[] = { "reject", "drop longest", "drop oldest" };
+
+  printf("%lld jobs at load %d%%, queue of %d\n", num, load, capacity);
+  for (int sjf = 0; sjf <= 1; sjf++) {
+    for (int policy = ADMIT_REJECT; policy <= ADMIT_DROP_OLDEST; policy++) {
+      generator gen = { num, 0, 0, load, seed };
+      sch_admission_config config = { capacity, policy };
+      sch_admission_report report;
+      double start = now_s();
+      sch_admit_generated(generator_next, &gen, sjf, &config, NULL, NULL, &report);
+      double elapsed = now_s() - start;
+      printf("%s %-12s %6.1f Mjobs/s, drop rate %.3f, goodput %.4f jobs/cycle, "
+             "wait avg %.1f p50 %.1f p99 %.1f max %lld\n",
+             sjf ? "SJF " : "FCFS", policies[policy], report.arrived / elapsed / 1e6,
+             report.drop_rate, report.goodput, report.wait_average,
+             report.wait_p50, report.wait_p99, report.wait_max);
+    }
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("max resident size %ld kB\n", usage.ru_maxrss);
+  return 0;
+}
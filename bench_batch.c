@@ -0,0 +1,77 @@
+/**
+  @brief Benchmark of sch_fcfs_batch against sch_fcfs on small problems.
+
+          ./bench_batch [problems] [min jobs] [max jobs]
+
+  Generates problems of min to max jobs, solves them one by one with
+  sch_fcfs and all at once with sch_fcfs_batch from a packed batch, checks
+  that the solutions are the same and prints the problems per second of
+  both. Packing the batch is not timed.
+*/
+
+#include "scheduling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1000000;
+  int min_jobs = argc > 2 ? atoi(argv[2]) : 4;
+  int max_jobs = argc > 3 ? atoi(argv[3]) : 64;
+  if (count < 1 || min_jobs < 0 || max_jobs < min_jobs) {
+    fprintf(stderr, "usage: %s [problems] [min jobs] [max jobs]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned int seed = 1;
+  sch_problem **problems = (sch_problem**) malloc(sizeof(sch_problem*) * count);
+  for (int i = 0; i < count; i++) {
+    sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+    sch->num = min_jobs + rand_r(&seed) % (max_jobs - min_jobs + 1);
+    sch_table_malloc(sch);
+    for (int j = 0; j < sch->num; j++) {
+      sch->table[j][ID] = j + 1;
+      sch->table[j][ARRIVAL] = rand_r(&seed) % (4 * sch->num + 1);
+      sch->table[j][BURST] = rand_r(&seed) % 8;
+    }
+    problems[i] = sch;
+  }
+
+  sch_batch_problem *packed = sch_batch_pack(problems, count);
+  double start = now_s();
+  sch_solution *batch = sch_fcfs_batch(packed);
+  double batch_time = now_s() - start;
+
+  int same = 1;
+  start = now_s();
+  for (int i = 0; i < count; i++) {
+    sch_solution *sol = sch_fcfs(problems[i]);
+    same &= sol->wait_total == batch[i].wait_total;
+    for (int j = 0; j < sol->num; j++)
+      same &= sol->order[j] == batch[i].order[j];
+    free(sol->order);
+    free(sol);
+  }
+  double single_time = now_s() - start;
+
+  printf("%d problems of %d to %d jobs, %s\n", count, min_jobs, max_jobs,
+         same ? "same solutions" : "DIFFERENT SOLUTIONS");
+  printf("sch_fcfs:       %.0f problems/s\n", count / single_time);
+  printf("sch_fcfs_batch: %.0f problems/s (%.1fx)\n", count / batch_time,
+         single_time / batch_time);
+
+  sch_batch_solutions_free(batch);
+  sch_batch_problem_free(packed);
+  for (int i = 0; i < count; i++) {
+    sch_table_free(problems[i]);
+    free(problems[i]);
+  }
+  free(problems);
+  return same ? 0 : 1;
+}
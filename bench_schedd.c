@@ -0,0 +1,117 @@
+/**
+  @brief Load generator for schedd.
+
+          ./bench_schedd [socket] [clients] [requests] [jobs]
+
+  Starts clients threads, each with its own connection, sending requests
+  problems of jobs random jobs, half FCFS and half SJF, as fast as the
+  daemon answers. Prints the p50 and p99 latency of a request and the
+  requests per second of all the clients. The first response of each
+  client is checked against sch_solve_jobs.
+*/
+
+#include "sch_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+typedef struct {
+  const char *path;
+  int requests;
+  int jobs;
+  unsigned int seed;
+  double *latency;
+  int ok;
+} bench_client;
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int double_compare(const void *a, const void *b) {
+  double x = *(const double*) a, y = *(const double*) b;
+  return x < y ? -1 : x > y;
+}
+
+static void * client_main(void *arg) {
+  bench_client *cl = (bench_client*) arg;
+  int *jobs = (int*) malloc(sizeof(int) * 3 * cl->jobs);
+  int *order = (int*) malloc(sizeof(int) * cl->jobs);
+  int *expected = (int*) malloc(sizeof(int) * cl->jobs);
+  for (int i = 0; i < cl->jobs; i++) {
+    jobs[3 * i + ID] = i + 1;
+    jobs[3 * i + ARRIVAL] = rand_r(&cl->seed) % (cl->jobs * 4 + 1);
+    jobs[3 * i + BURST] = rand_r(&cl->seed) % 10;
+  }
+
+  cl->ok = 0;
+  int fd = sch_client_connect(cl->path);
+  if (fd >= 0) {
+    cl->ok = 1;
+    for (int r = 0; r < cl->requests && cl->ok; r++) {
+      int policy = r % 2 ? SCHD_SJF : SCHD_FCFS;
+      long long wait_total;
+      double start = now_ns();
+      cl->ok = sch_client_solve_jobs(fd, policy, cl->jobs, jobs, order, &wait_total) == SCHD_OK;
+      cl->latency[r] = now_ns() - start;
+      if (cl->ok && r < 2) {
+        sch_arena *arena = sch_arena_malloc();
+        cl->ok = sch_solve_jobs(arena, cl->jobs, jobs, policy == SCHD_SJF, expected) == wait_total &&
+                 memcmp(order, expected, sizeof(int) * cl->jobs) == 0;
+        sch_arena_free(arena);
+      }
+    }
+    sch_client_close(fd);
+  }
+
+  free(jobs);
+  free(order);
+  free(expected);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : SCHD_SOCKET;
+  int clients = argc > 2 ? atoi(argv[2]) : 8;
+  int requests = argc > 3 ? atoi(argv[3]) : 10000;
+  int jobs = argc > 4 ? atoi(argv[4]) : 64;
+  if (clients < 1 || requests < 1 || jobs < 1) {
+    fprintf(stderr, "usage: %s [socket] [clients] [requests] [jobs]\n", argv[0]);
+    return 1;
+  }
+
+  bench_client *cl = (bench_client*) malloc(sizeof(bench_client) * clients);
+  pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * clients);
+  double *latency = (double*) malloc(sizeof(double) * clients * (size_t) requests);
+  double start = now_ns();
+  for (int c = 0; c < clients; c++) {
+    cl[c] = (bench_client) { path, requests, jobs, 1234u + c, &latency[(size_t) c * requests], 0 };
+    pthread_create(&threads[c], NULL, client_main, &cl[c]);
+  }
+  int ok = 1;
+  for (int c = 0; c < clients; c++) {
+    pthread_join(threads[c], NULL);
+    ok &= cl[c].ok;
+  }
+  double elapsed = now_ns() - start;
+
+  if (!ok) {
+    fprintf(stderr, "bench_schedd: a client failed, is schedd running on %s?\n", path);
+  } else {
+    long total = (long) clients * requests;
+    qsort(latency, total, sizeof(double), double_compare);
+    printf("%d clients x %d requests of %d jobs\n", clients, requests, jobs);
+    printf("p50 %.1f us, p99 %.1f us, %.0f requests/s\n",
+           latency[total / 2] / 1e3, latency[total * 99 / 100] / 1e3,
+           total / (elapsed / 1e9));
+  }
+
+  free(latency);
+  free(threads);
+  free(cl);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+/**
+  @brief Benchmark of sch_tune_quantum with the number of threads.
+
+          ./bench_tune [jobs] [max threads] [levels]
+
+  Generates a random trace of jobs at 90% load with bursts from 1 to 99,
+  then searches the RR (levels = 1) or MLFQ quantum from 1 to 64 for the
+  average wait and for the 99th percentile response time, with 1, 2, 4,
+  ... up to max threads. Prints the time and the speedup of each run, the
+  best quantum and how many candidates were pruned.
+*/
+
+#include "scheduling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+static double now_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+  int num = argc > 1 ? atoi(argv[1]) : 200000;
+  int max_threads = argc > 2 ? atoi(argv[2]) : 8;
+  int levels = argc > 3 ? atoi(argv[3]) : 1;
+  if (num < 1 || max_threads < 1 || levels < 1) {
+    fprintf(stderr, "usage: %s [jobs] [max threads] [levels]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned int seed = 1;
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = num;
+  sch_table_malloc(sch);
+  double arrival = 0.0;
+  for (int i = 0; i < num; i++) {
+    arrival += -50.0 / 0.9 * log((rand_r(&seed) + 1.0) / (RAND_MAX + 2.0));
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = (int) arrival;
+    sch->table[i][BURST] = 1 + rand_r(&seed) % 99;
+  }
+
+  for (int objective = TUNE_WAIT; objective <= TUNE_P99_RESPONSE; objective++) {
+    double single = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+      sch_tune_config config = { levels, 1, 64, 1, objective, threads };
+      sch_tune_report report;
+      double start = now_s();
+      sch_tune_quantum(sch, &config, &report);
+      double time = now_s() - start;
+      if (threads == 1)
+        single = time;
+      printf("%s %2d threads: quantum %d, score %.2f, %d evaluated, %d pruned, "
+             "%.3f s (%.2fx)\n", objective == TUNE_WAIT ? "wait" : "p99 ",
+             threads, report.quantum, report.score, report.evaluated,
+             report.pruned, time, single / time);
+    }
+  }
+
+  sch_table_free(sch);
+  free(sch);
+  return 0;
+}
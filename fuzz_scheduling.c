@@ -0,0 +1,466 @@
+/**
+  @brief Differential testing of the scheduling engines.
+
+  Every instance is solved by the reference tick-by-tick engine behind
+  sch_fcfs and sch_sjf, and by each faster engine that must give the
+  same result: the packed engine, also with the arrivals shifted close
+  to INT_MAX and refusing arrivals before cycle 0, the FCFS batch, the
+  I/O engine with CPU bursts only, the multi-core engine with a single
+  core of speed 100, the DAG engine without dependencies, sch_solve_jobs
+  on a flat array, sch_stream, a forked sch_engine, and EDF with
+  deadlines that make it behave like FCFS (DEADLINE = ARRIVAL) or SJF
+  (DEADLINE = BURST). The order and the exact total wait must match, as
+  for RR and MLFQ with a quantum longer than any burst against FCFS. The
+  oracle of the predicted SJF must have the average wait of SJF, FCFS on
+  one core with outages the waits of a tick by tick simulation of the
+  outages, and FCFS and SJF with a ready queue as long as the problem
+  must drop nothing.
+
+  Built with -DSCH_LIBFUZZER it is a libFuzzer target. Otherwise main
+  generates instances from a seeded generator:
+
+          ./fuzzsched [seed] [iterations]
+
+  and when an instance fails, it is minimized and printed as a test to
+  add to test_scheduling.c.
+*/
+
+#include "scheduling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_JOBS 16
+#define FUZZ_MAX_ID 64
+// shift of the arrivals, which are below 16, for the packed engine
+#define FUZZ_FAR_ARRIVAL (2147483647 - 16)
+
+typedef struct {
+  int num;
+  int id[FUZZ_MAX_JOBS];
+  int arrival[FUZZ_MAX_JOBS];
+  int burst[FUZZ_MAX_JOBS];
+} fuzz_instance;
+
+int fuzz_check(fuzz_instance *inst, int verbose);
+
+/**
+   Decodes an instance from bytes: the number of jobs, then an ID, an
+   arrival and a burst byte for each job. Arrivals and bursts are kept
+   small to get many ties and zero bursts, IDs are made unique.
+ */
+void fuzz_decode(const unsigned char *data, size_t size, fuzz_instance *inst) {
+  char used[FUZZ_MAX_ID + FUZZ_MAX_JOBS + 1] = {0};
+  inst->num = size > 0 ? data[0] % (FUZZ_MAX_JOBS + 1) : 0;
+  if ((size_t) inst->num > (size - 1) / 3)
+    inst->num = size > 0 ? (size - 1) / 3 : 0;
+  for (int i = 0; i < inst->num; i++) {
+    int id = data[1 + 3 * i] % FUZZ_MAX_ID + 1;
+    while (used[id])
+      id++;
+    used[id] = 1;
+    inst->id[i] = id;
+    inst->arrival[i] = data[2 + 3 * i] % 16;
+    inst->burst[i] = data[3 + 3 * i] % 8;
+  }
+}
+
+sch_problem * fuzz_problem(fuzz_instance *inst) {
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = inst->num;
+  sch_table_malloc(sch);
+  for (int i = 0; i < inst->num; i++) {
+    sch->table[i][ID] = inst->id[i];
+    sch->table[i][ARRIVAL] = inst->arrival[i];
+    sch->table[i][BURST] = inst->burst[i];
+  }
+  return sch;
+}
+
+void fuzz_free(sch_problem *sch, sch_solution *sol) {
+  if (sch != NULL) {
+    sch_table_free(sch);
+    free(sch);
+  }
+  free(sol->order);
+  free(sol);
+}
+
+/**
+   Compares a solution with the reference one, prints the difference.
+
+   @return 1 if they are equal, 0 otherwise
+ */
+int fuzz_same(char *engine, sch_solution *ref, sch_solution *sol, int verbose) {
+  int same = ref->num == sol->num && ref->wait_total == sol->wait_total;
+  for (int i = 0; same && i < ref->num; i++) {
+    same = ref->order[i] == sol->order[i];
+  }
+  if (!same && verbose) {
+    printf("%s differs: wait %lld instead of %lld, order", engine,
+      sol->wait_total, ref->wait_total);
+    for (int i = 0; i < sol->num; i++)
+      printf(" %d", sol->order[i]);
+    printf(" instead of");
+    for (int i = 0; i < ref->num; i++)
+      printf(" %d", ref->order[i]);
+    printf("\n");
+  }
+  return same;
+}
+
+static int fuzz_down(int count, long long *start, long long *end, long long t) {
+  for (int o = 0; o < count; o++) {
+    if (start[o] <= t && t < end[o])
+      return 1;
+  }
+  return 0;
+}
+
+/**
+   Reference of FCFS on one CPU down during the count outages [start,
+   end), tick by tick, for the jobs of inst in the order of ref.
+
+   @return the total wait
+ */
+long long fuzz_outage_wait(fuzz_instance *inst, sch_solution *ref, int count,
+                           long long *start, long long *end, int policy) {
+  long long cycle = 0, wait_time = 0;
+  for (int r = 0; r < ref->num; r++) {
+    int i = 0;
+    while (inst->id[i] != ref->order[r])
+      i++;
+    long long t = cycle > inst->arrival[i] ? cycle : inst->arrival[i], finish;
+    if (policy == OUTAGE_RESUME) {
+      while (fuzz_down(count, start, end, t))
+        t++;
+      finish = t;
+      for (int left = inst->burst[i]; left > 0; finish++) {
+        if (!fuzz_down(count, start, end, finish))
+          left--;
+      }
+    } else {
+      int fits = 0;
+      while (!fits) {
+        fits = !fuzz_down(count, start, end, t);
+        for (int k = 0; k < inst->burst[i] && fits; k++)
+          fits = !fuzz_down(count, start, end, t + k);
+        if (!fits)
+          t++;
+      }
+      finish = t + inst->burst[i];
+    }
+    wait_time += finish - inst->burst[i] - inst->arrival[i];
+    cycle = finish;
+  }
+  return wait_time;
+}
+
+static void fuzz_drop(void *ctx, const sch_drop_record *record) {
+  (void) record;
+  (*(long long*) ctx)++;
+}
+
+static void fuzz_record(void *ctx, const sch_dispatch_record *record) {
+  int **next = (int**) ctx;
+  *(*next)++ = record->id;
+}
+
+/**
+   Solves inst with every engine.
+
+   @return 1 if all engines agree with the reference, 0 otherwise
+ */
+int fuzz_check(fuzz_instance *inst, int verbose) {
+  int ok = 1;
+  for (int sjf = 0; sjf <= 1; sjf++) {
+    sch_problem *sch = fuzz_problem(inst);
+    sch_solution *ref = sjf ? sch_sjf(sch) : sch_fcfs(sch);
+    sch_table_free(sch);
+    free(sch);
+
+    sch_problem *plain = fuzz_problem(inst);
+    sch_packed_problem *pk = sch_pack(plain);
+    sch_solution *sol = sjf ? sch_sjf_packed(pk) : sch_fcfs_packed(pk);
+    ok &= fuzz_same(sjf ? "sjf packed" : "fcfs packed", ref, sol, verbose);
+    if (sch_packed_append(pk, FUZZ_MAX_ID + FUZZ_MAX_JOBS + 1, -1 - inst->num, 1)) {
+      if (verbose)
+        printf("packed accepts an arrival before cycle 0\n");
+      ok = 0;
+    }
+    sch_packed_free(pk);
+    fuzz_free(plain, sol);
+
+    // the same schedule shifted up to the end of the int arrivals
+    plain = fuzz_problem(inst);
+    for (int i = 0; i < inst->num; i++)
+      plain->table[i][ARRIVAL] += FUZZ_FAR_ARRIVAL;
+    pk = sch_pack(plain);
+    sol = sjf ? sch_sjf_packed(pk) : sch_fcfs_packed(pk);
+    ok &= fuzz_same(sjf ? "sjf packed far" : "fcfs packed far", ref, sol, verbose);
+    sch_packed_free(pk);
+    fuzz_free(plain, sol);
+
+    sch_io_problem *io = sch_io_problem_malloc(inst->num, inst->num, 0);
+    for (int i = 0; i < inst->num; i++) {
+      io->id[i] = inst->id[i];
+      io->arrival[i] = inst->arrival[i];
+      io->first_phase[i + 1] = i + 1;
+      io->phase_length[i] = inst->burst[i];
+      io->phase_device[i] = IO_CPU;
+    }
+    sol = sjf ? sch_sjf_io(io, NULL) : sch_fcfs_io(io, NULL);
+    ok &= fuzz_same(sjf ? "sjf i/o" : "fcfs i/o", ref, sol, verbose);
+    sch_io_problem_free(io);
+    fuzz_free(NULL, sol);
+
+    int speed = 100;
+    plain = fuzz_problem(inst);
+    sol = sch_cores(plain, 1, &speed, sjf ? PLACE_SJF_FAST : PLACE_FASTEST, NULL);
+    ok &= fuzz_same(sjf ? "sjf 1 core" : "fcfs 1 core", ref, sol, verbose);
+    fuzz_free(plain, sol);
+
+    plain = fuzz_problem(inst);
+    sch_dag *dag = sch_dag_from_edges(inst->num, 0, NULL, NULL);
+    sol = sch_dag_schedule(plain, dag, sjf ? DAG_SJF : DAG_FCFS, NULL);
+    ok &= fuzz_same(sjf ? "sjf dag" : "fcfs dag", ref, sol, verbose);
+    sch_dag_free(dag);
+    fuzz_free(plain, sol);
+
+    int jobs[3 * FUZZ_MAX_JOBS];
+    for (int i = 0; i < inst->num; i++) {
+      jobs[3 * i + ID] = inst->id[i];
+      jobs[3 * i + ARRIVAL] = inst->arrival[i];
+      jobs[3 * i + BURST] = inst->burst[i];
+    }
+    sch_arena *arena = sch_arena_malloc();
+    sol = (sch_solution*) malloc(sizeof(sch_solution));
+    sol->num = inst->num;
+    sol->order = (int*) malloc(sizeof(int) * (inst->num > 0 ? inst->num : 1));
+    sol->wait_total = sch_solve_jobs(arena, inst->num, jobs, sjf, sol->order);
+    ok &= fuzz_same(sjf ? "sjf flat" : "fcfs flat", ref, sol, verbose);
+    sch_arena_free(arena);
+    fuzz_free(NULL, sol);
+
+    plain = fuzz_problem(inst);
+    sol = (sch_solution*) malloc(sizeof(sch_solution));
+    sol->num = inst->num;
+    sol->order = (int*) malloc(sizeof(int) * (inst->num > 0 ? inst->num : 1));
+    int *next = sol->order;
+    sch_summary summary;
+    sch_stream(plain, sjf, fuzz_record, &next, &summary);
+    sol->wait_total = summary.wait_total;
+    ok &= fuzz_same(sjf ? "sjf stream" : "fcfs stream", ref, sol, verbose);
+
+    // the table is now sorted: run half of it, fork, and finish the copy
+    sch_engine *eng = sch_engine_malloc(sjf);
+    next = sol->order;
+    sch_engine_run(eng, plain, inst->num * 4, fuzz_record, &next);
+    sch_engine *fork = sch_engine_copy(eng);
+    sch_engine_free(eng);
+    sch_engine_run(fork, plain, -1, fuzz_record, &next);
+    sch_engine_summary(fork, &summary);
+    sol->wait_total = summary.wait_total;
+    ok &= fuzz_same(sjf ? "sjf fork" : "fcfs fork", ref, sol, verbose);
+    sch_engine_free(fork);
+    fuzz_free(plain, sol);
+
+    if (!sjf) {
+      // the same problem in lanes of a batch with a shorter one
+      sch_problem *batch[3] = { fuzz_problem(inst), fuzz_problem(inst), fuzz_problem(inst) };
+      batch[1]->num = inst->num / 2;
+      sch_batch_problem *packed = sch_batch_pack(batch, 3);
+      sch_solution *sols = sch_fcfs_batch(packed);
+      ok &= fuzz_same("fcfs batch", ref, &sols[0], verbose);
+      ok &= fuzz_same("fcfs batch", ref, &sols[2], verbose);
+      sch_batch_solutions_free(sols);
+      sch_batch_problem_free(packed);
+      batch[1]->num = inst->num;
+      for (int b = 0; b < 3; b++) {
+        sch_table_free(batch[b]);
+        free(batch[b]);
+      }
+
+      // outages of one core, overlapping, against the tick by tick
+      // reference
+      int count = inst->num / 2;
+      long long wait_total = ref->wait_total;
+      long long start[FUZZ_MAX_JOBS], end[FUZZ_MAX_JOBS];
+      for (int o = 0; o < count; o++) {
+        start[o] = inst->arrival[2 * o] + inst->burst[2 * o + 1];
+        end[o] = start[o] + 1 + inst->id[2 * o] % 6;
+      }
+      int *core = (int*) calloc(count > 0 ? count : 1, sizeof(int));
+      sch_outages *outages = sch_outages_from_intervals(1, count, core, start, end);
+      for (int policy = OUTAGE_DEFER; policy <= OUTAGE_RESUME; policy++) {
+        plain = fuzz_problem(inst);
+        sol = sch_cores_outages(plain, 1, &speed, PLACE_FASTEST, outages, policy, NULL);
+        ref->wait_total = fuzz_outage_wait(inst, ref, count, start, end, policy);
+        ok &= fuzz_same(policy == OUTAGE_DEFER ? "fcfs deferred by outages" :
+                        "fcfs resumed after outages", ref, sol, verbose);
+        fuzz_free(plain, sol);
+      }
+      ref->wait_total = wait_total;
+      sch_outages_free(outages);
+      free(core);
+
+      // with a quantum longer than any burst, RR and MLFQ are FCFS
+      plain = fuzz_problem(inst);
+      sol = sch_mlfq(plain, 1 + inst->num % 3, 8);
+      ok &= fuzz_same("long quantum rr", ref, sol, verbose);
+      fuzz_free(plain, sol);
+    }
+
+    // the oracle of the predicted SJF is SJF
+    if (sjf) {
+      plain = fuzz_problem(inst);
+      sch_predict_config config = { 0.5f, 4.0f, 0 };
+      sch_predict_report report;
+      sol = sch_sjf_predicted(plain, 1, NULL, &config, &report);
+      if (report.oracle_wait_average != ref->wait_average) {
+        if (verbose)
+          printf("predicted sjf oracle differs: wait %f instead of %f\n",
+            report.oracle_wait_average, ref->wait_average);
+        ok = 0;
+      }
+      fuzz_free(plain, sol);
+    }
+
+    // a queue long enough drops nothing, a short one accounts for every job
+    for (int policy = ADMIT_REJECT; policy <= ADMIT_DROP_OLDEST; policy++) {
+      sch_admission_config config = { inst->num > 0 ? inst->num : 1, policy };
+      sch_admission_report report;
+      long long drops = 0, waits = 0;
+      plain = fuzz_problem(inst);
+      sch_admit(plain, sjf, &config, fuzz_drop, &drops, &report);
+      if (report.dropped != 0 || report.wait_total != ref->wait_total) {
+        if (verbose)
+          printf("admission differs: wait %lld instead of %lld, %lld dropped\n",
+            report.wait_total, ref->wait_total, report.dropped);
+        ok = 0;
+      }
+      config.capacity = 1 + inst->num % 3;
+      sch_admit(plain, sjf, &config, fuzz_drop, &drops, &report);
+      for (int b = 0; b < ADMIT_WAIT_BUCKETS; b++)
+        waits += report.wait_histogram[b];
+      if (report.arrived != inst->num || report.admitted + report.dropped != inst->num ||
+          drops != report.dropped || waits != report.admitted ||
+          report.queue_max > config.capacity) {
+        if (verbose)
+          printf("admission with a queue of %d loses jobs: %lld admitted, %lld dropped\n",
+            config.capacity, report.admitted, report.dropped);
+        ok = 0;
+      }
+      sch_table_free(plain);
+      free(plain);
+    }
+
+    plain = fuzz_problem(inst);
+    for (int i = 0; i < inst->num; i++) {
+      plain->table[i][DEADLINE] = sjf ? inst->burst[i] : inst->arrival[i];
+    }
+    sol = sch_edf(plain, 0, NULL);
+    ok &= fuzz_same(sjf ? "edf as sjf" : "edf as fcfs", ref, sol, verbose);
+    fuzz_free(plain, sol);
+
+    free(ref->order);
+    free(ref);
+  }
+  return ok;
+}
+
+/**
+   Shrinks a failing instance while it keeps failing: removes jobs, then
+   lowers arrivals and bursts one by one.
+ */
+void fuzz_minimize(fuzz_instance *inst) {
+  int progress = 1;
+  while (progress) {
+    progress = 0;
+    for (int i = 0; i < inst->num; i++) {
+      fuzz_instance smaller = *inst;
+      memmove(&smaller.id[i], &smaller.id[i + 1], sizeof(int) * (smaller.num - i - 1));
+      memmove(&smaller.arrival[i], &smaller.arrival[i + 1], sizeof(int) * (smaller.num - i - 1));
+      memmove(&smaller.burst[i], &smaller.burst[i + 1], sizeof(int) * (smaller.num - i - 1));
+      smaller.num--;
+      if (!fuzz_check(&smaller, 0)) {
+        *inst = smaller;
+        progress = 1;
+        i--;
+      }
+    }
+    for (int i = 0; i < inst->num; i++) {
+      while (inst->arrival[i] > 0 || inst->burst[i] > 0) {
+        fuzz_instance smaller = *inst;
+        if (smaller.arrival[i] > 0)
+          smaller.arrival[i]--;
+        else
+          smaller.burst[i]--;
+        if (fuzz_check(&smaller, 0))
+          break;
+        *inst = smaller;
+        progress = 1;
+      }
+    }
+  }
+}
+
+/**
+   Prints inst as a scheduling problem instance in the style of the tests
+   of test_scheduling.c.
+ */
+void fuzz_print_regression(fuzz_instance *inst) {
+  printf("  // scheduling problem instance found by fuzz_scheduling\n");
+  printf("  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));\n");
+  printf("  sch->num = %d;\n", inst->num);
+  printf("  sch_table_malloc(sch);\n");
+  for (int i = 0; i < inst->num; i++) {
+    printf("  sch->table[%d][ID] = %d;\n", i, inst->id[i]);
+    printf("  sch->table[%d][ARRIVAL] = %d;\n", i, inst->arrival[i]);
+    printf("  sch->table[%d][BURST] = %d;\n", i, inst->burst[i]);
+  }
+}
+
+#ifdef SCH_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size) {
+  fuzz_instance inst;
+  fuzz_decode(data, size, &inst);
+  if (!fuzz_check(&inst, 1)) {
+    fuzz_print_regression(&inst);
+    abort();
+  }
+  return 0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+  unsigned long long seed = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+  long iterations = argc > 2 ? strtol(argv[2], NULL, 10) : 10000;
+  unsigned long long state = seed * 0x9E3779B97F4A7C15ULL + 1;
+  unsigned char data[1 + 3 * FUZZ_MAX_JOBS];
+
+  for (long it = 0; it < iterations; it++) {
+    for (size_t i = 0; i < sizeof(data); i++) {
+      // xorshift64*, one byte per step
+      state ^= state >> 12;
+      state ^= state << 25;
+      state ^= state >> 27;
+      data[i] = (unsigned char)((state * 0x2545F4914F6CDD1DULL) >> 56);
+    }
+    fuzz_instance inst;
+    fuzz_decode(data, sizeof(data), &inst);
+    if (!fuzz_check(&inst, 0)) {
+      printf("Iteration %ld (seed %llu) failed, minimized instance:\n", it, seed);
+      fuzz_minimize(&inst);
+      fuzz_check(&inst, 1);
+      fuzz_print_regression(&inst);
+      return 1;
+    }
+  }
+  printf("%ld instances, all engines agree with the reference.\n", iterations);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,151 @@
+/**
+  @brief Client library of schedd, the scheduling daemon.
+
+  Connect once with sch_client_connect and send any number of problems on
+  the same connection, the daemon keeps running between them.
+*/
+
+#include "sch_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+   Writes size bytes to fd, continuing after partial writes.
+
+   @return 1 on success, 0 on error
+ */
+static int write_all(int fd, const void *buffer, size_t size) {
+  const char *p = (const char*) buffer;
+  while (size > 0) {
+    ssize_t done = write(fd, p, size);
+    if (done <= 0)
+      return 0;
+    p += done;
+    size -= done;
+  }
+  return 1;
+}
+
+/**
+   Reads size bytes from fd, continuing after partial reads.
+
+   @return 1 on success, 0 on error or end of file
+ */
+static int read_all(int fd, void *buffer, size_t size) {
+  char *p = (char*) buffer;
+  while (size > 0) {
+    ssize_t done = read(fd, p, size);
+    if (done <= 0)
+      return 0;
+    p += done;
+    size -= done;
+  }
+  return 1;
+}
+
+/**
+   Connects to a running schedd.
+
+   @param path the path of the socket of the daemon, or NULL for SCHD_SOCKET
+
+   @return the connected socket, or -1 on error
+ */
+int sch_client_connect(const char *path) {
+  struct sockaddr_un addr;
+  if (path == NULL)
+    path = SCHD_SOCKET;
+  if (strlen(path) >= sizeof(addr.sun_path))
+    return -1;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+   Closes a connection to schedd.
+
+   @param fd the socket returned by sch_client_connect
+ */
+void sch_client_close(int fd) {
+  close(fd);
+}
+
+/**
+   Solves jobs given as a flat array on schedd, without allocating.
+
+   @param fd the socket returned by sch_client_connect
+   @param policy SCHD_FCFS or SCHD_SJF
+   @param num the number of jobs
+   @param jobs the ID, ARRIVAL and BURST of each job, one triple after the
+          other, in any order
+   @param order the address where to store the IDs of the num jobs in the
+          order they run
+   @param wait_total the address where to store the total wait
+
+   @return the status of the response, or -1 if the connection failed
+ */
+int sch_client_solve_jobs(int fd, int policy, int num, const int *jobs,
+                          int *order, long long *wait_total) {
+  sch_request_header req = { SCHD_MAGIC_REQUEST, policy, num };
+  if (!write_all(fd, &req, sizeof(req)) ||
+      !write_all(fd, jobs, sizeof(int) * 3 * (size_t) num))
+    return -1;
+
+  sch_response_header res;
+  if (!read_all(fd, &res, sizeof(res)) || res.magic != SCHD_MAGIC_RESPONSE)
+    return -1;
+  if (res.status != SCHD_OK)
+    return res.status;
+  if (res.num != num || !read_all(fd, order, sizeof(int) * (size_t) num))
+    return -1;
+  *wait_total = res.wait_total;
+  return SCHD_OK;
+}
+
+/**
+   Compute the solution to a scheduling problem on schedd. Same as sch_fcfs
+   or sch_sjf, without starting a process or printing the problem.
+
+   @param fd the socket returned by sch_client_connect
+   @param sch the address of the scheduling problem to solve
+   @param policy SCHD_FCFS or SCHD_SJF
+
+   @return the address of the computed scheduling solution, or NULL on error
+ */
+sch_solution * sch_client_solve(int fd, sch_problem *sch, int policy) {
+  int *jobs = (int*) malloc(sizeof(int) * 3 * (sch->num > 0 ? sch->num : 1));
+  for (int i = 0; i < sch->num; i++) {
+    jobs[3 * i + ID] = sch->table[i][ID];
+    jobs[3 * i + ARRIVAL] = sch->table[i][ARRIVAL];
+    jobs[3 * i + BURST] = sch->table[i][BURST];
+  }
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sol->order = (int*) malloc(sizeof(int) * (sch->num > 0 ? sch->num : 1));
+  sol->wait_average = 0.0;
+  int status = sch_client_solve_jobs(fd, policy, sch->num, jobs, sol->order,
+                                     &sol->wait_total);
+  free(jobs);
+  if (status != SCHD_OK) {
+    free(sol->order);
+    free(sol);
+    return NULL;
+  }
+  if (sch->num > 0)
+    sol->wait_average = (double) sol->wait_total / sch->num;
+  return sol;
+}
@@ -0,0 +1,51 @@
+#ifndef SCH_CLIENT_H
+#define SCH_CLIENT_H
+
+#include "scheduling.h"
+
+/*
+  Protocol of schedd, the scheduling daemon, over a Unix domain socket.
+  All the fields are int in native byte order, the client and the daemon
+  run on the same machine. A connection sends one request at a time and
+  reads its response before sending the next one.
+
+  Request:  MAGIC_REQUEST, policy, num, then num triples ID, ARRIVAL, BURST
+  Response: MAGIC_RESPONSE, status, num, then the total wait as a long
+            long, then the num IDs in the order they run (none unless
+            status is SCHD_OK)
+
+  A request with a bad magic or a num out of [0, SCHD_MAX_JOBS] closes the
+  connection.
+*/
+#define SCHD_MAGIC_REQUEST  0x51484353
+#define SCHD_MAGIC_RESPONSE 0x52484353
+#define SCHD_MAX_JOBS       (1 << 24)
+#define SCHD_SOCKET         "/tmp/schedd.sock"
+
+#define SCHD_FCFS 0
+#define SCHD_SJF  1
+
+#define SCHD_OK         0
+#define SCHD_BAD_POLICY 1
+
+typedef struct {
+  int magic;
+  int policy;
+  int num;
+} sch_request_header;
+
+typedef struct {
+  int magic;
+  int status;
+  int num;
+  int unused;
+  long long wait_total;
+} sch_response_header;
+
+int  sch_client_connect(const char *path);
+void sch_client_close(int fd);
+int  sch_client_solve_jobs(int fd, int policy, int num, const int *jobs,
+                           int *order, long long *wait_total);
+sch_solution * sch_client_solve(int fd, sch_problem *sch, int policy);
+
+#endif
@@ -0,0 +1,287 @@
+/**
+  @brief Scheduling daemon: solves FCFS and SJF problems sent over a Unix
+  domain socket, so that callers do not pay a process start per problem.
+
+          ./schedd [socket] [workers] [batch]
+
+  Each connection has a reader thread that reads one request at a time
+  into the buffer of the connection, queues it and waits for its response.
+  A pool of workers takes the queued requests by batches of up to batch
+  requests with one lock, so a burst of concurrent requests costs one
+  wake-up per batch. Each worker keeps an arena (sch_solve_jobs) and an
+  order buffer, and each connection its request buffer: once warm, the
+  daemon does not allocate. See sch_client.h for the protocol.
+
+  SIGINT or SIGTERM stops the daemon and removes the socket.
+*/
+
+#include "sch_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+/*
+  A connection, and its request while it is queued.
+*/
+typedef struct connection {
+  int fd;
+  sch_request_header req;
+  int *jobs;
+  int capacity;
+  int done;
+  pthread_cond_t done_cond;
+  struct connection *next;
+} connection;
+
+/*
+  Queue of the requests waiting for a worker.
+*/
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  connection *head;
+  connection *tail;
+  int batch;
+  int stop;
+} request_queue;
+
+static request_queue queue = {
+  PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 1, 0
+};
+static volatile sig_atomic_t stopping = 0;
+
+static void on_signal(int sig) {
+  (void) sig;
+  stopping = 1;
+}
+
+static int read_all(int fd, void *buffer, size_t size) {
+  char *p = (char*) buffer;
+  while (size > 0) {
+    ssize_t done = read(fd, p, size);
+    if (done <= 0)
+      return 0;
+    p += done;
+    size -= done;
+  }
+  return 1;
+}
+
+/**
+   Sends a response header then num IDs in as few writes as possible.
+
+   @return 1 on success, 0 on error
+ */
+static int send_response(int fd, sch_response_header *res, int *order) {
+  struct iovec iov[2] = {
+    { res, sizeof(sch_response_header) },
+    { order, sizeof(int) * (size_t) res->num }
+  };
+  int count = res->num > 0 ? 2 : 1;
+  while (count > 0) {
+    ssize_t done = writev(fd, iov, count);
+    if (done <= 0)
+      return 0;
+    for (int i = 0; i < count && done > 0; ) {
+      size_t part = (size_t) done < iov[i].iov_len ? (size_t) done : iov[i].iov_len;
+      iov[i].iov_base = (char*) iov[i].iov_base + part;
+      iov[i].iov_len -= part;
+      done -= part;
+      if (iov[i].iov_len == 0) {
+        memmove(&iov[i], &iov[i + 1], sizeof(struct iovec) * (count - i - 1));
+        count--;
+      } else {
+        i++;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+   Worker of the pool: solves the queued requests by batches and answers
+   them on their connection.
+ */
+static void * worker_main(void *arg) {
+  (void) arg;
+  sch_arena *arena = sch_arena_malloc();
+  int capacity = 0;
+  int *order = NULL;
+  connection **batch = (connection**) malloc(sizeof(connection*) * queue.batch);
+
+  while (1) {
+    pthread_mutex_lock(&queue.lock);
+    while (queue.head == NULL && !queue.stop)
+      pthread_cond_wait(&queue.ready, &queue.lock);
+    if (queue.head == NULL) {
+      pthread_mutex_unlock(&queue.lock);
+      break;
+    }
+    int size = 0;
+    while (queue.head != NULL && size < queue.batch) {
+      batch[size++] = queue.head;
+      queue.head = queue.head->next;
+    }
+    if (queue.head == NULL)
+      queue.tail = NULL;
+    pthread_mutex_unlock(&queue.lock);
+
+    for (int b = 0; b < size; b++) {
+      connection *conn = batch[b];
+      sch_response_header res = { SCHD_MAGIC_RESPONSE, SCHD_OK, conn->req.num, 0, 0 };
+      if (conn->req.policy != SCHD_FCFS && conn->req.policy != SCHD_SJF) {
+        res.status = SCHD_BAD_POLICY;
+        res.num = 0;
+      } else {
+        if (conn->req.num > capacity) {
+          capacity = conn->req.num;
+          order = (int*) realloc(order, sizeof(int) * capacity);
+        }
+        res.wait_total = sch_solve_jobs(arena, conn->req.num, conn->jobs,
+                                        conn->req.policy == SCHD_SJF, order);
+      }
+      int sent = send_response(conn->fd, &res, order);
+
+      pthread_mutex_lock(&queue.lock);
+      conn->done = sent ? 1 : -1;
+      pthread_cond_signal(&conn->done_cond);
+      pthread_mutex_unlock(&queue.lock);
+    }
+  }
+
+  free(batch);
+  free(order);
+  sch_arena_free(arena);
+  return NULL;
+}
+
+/**
+   Reader of a connection: reads a request, queues it and waits until a
+   worker has answered, until the client closes the connection or sends a
+   bad request.
+ */
+static void * connection_main(void *arg) {
+  connection *conn = (connection*) arg;
+
+  while (read_all(conn->fd, &conn->req, sizeof(sch_request_header))) {
+    if (conn->req.magic != SCHD_MAGIC_REQUEST || conn->req.num < 0 ||
+        conn->req.num > SCHD_MAX_JOBS)
+      break;
+    if (conn->req.num > conn->capacity) {
+      conn->capacity = conn->req.num;
+      conn->jobs = (int*) realloc(conn->jobs, sizeof(int) * 3 * (size_t) conn->capacity);
+    }
+    if (!read_all(conn->fd, conn->jobs, sizeof(int) * 3 * (size_t) conn->req.num))
+      break;
+
+    pthread_mutex_lock(&queue.lock);
+    conn->done = 0;
+    conn->next = NULL;
+    if (queue.tail != NULL)
+      queue.tail->next = conn;
+    else
+      queue.head = conn;
+    queue.tail = conn;
+    pthread_cond_signal(&queue.ready);
+    while (conn->done == 0)
+      pthread_cond_wait(&conn->done_cond, &queue.lock);
+    int sent = conn->done > 0;
+    pthread_mutex_unlock(&queue.lock);
+    if (!sent)
+      break;
+  }
+
+  close(conn->fd);
+  pthread_cond_destroy(&conn->done_cond);
+  free(conn->jobs);
+  free(conn);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : SCHD_SOCKET;
+  int workers = argc > 2 ? atoi(argv[2]) : 4;
+  queue.batch = argc > 3 ? atoi(argv[3]) : 16;
+  if (workers < 1 || queue.batch < 1) {
+    fprintf(stderr, "usage: %s [socket] [workers >= 1] [batch >= 1]\n", argv[0]);
+    return 1;
+  }
+
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "schedd: socket path too long\n");
+    return 1;
+  }
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    perror("schedd: socket");
+    return 1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  unlink(path);
+  if (bind(listener, (struct sockaddr*) &addr, sizeof(addr)) < 0 ||
+      listen(listener, 64) < 0) {
+    perror("schedd: bind");
+    close(listener);
+    return 1;
+  }
+
+  // accept is interrupted by the signals instead of restarted
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = on_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  pthread_t *pool = (pthread_t*) malloc(sizeof(pthread_t) * workers);
+  for (int w = 0; w < workers; w++)
+    pthread_create(&pool[w], NULL, worker_main, NULL);
+  printf("schedd: listening on %s with %d workers, batches of %d\n",
+         path, workers, queue.batch);
+  fflush(stdout);
+
+  while (!stopping) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      perror("schedd: accept");
+      break;
+    }
+    connection *conn = (connection*) malloc(sizeof(connection));
+    conn->fd = fd;
+    conn->jobs = NULL;
+    conn->capacity = 0;
+    pthread_cond_init(&conn->done_cond, NULL);
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, connection_main, conn) != 0) {
+      close(fd);
+      pthread_cond_destroy(&conn->done_cond);
+      free(conn);
+      continue;
+    }
+    pthread_detach(thread);
+  }
+
+  // The workers finish the queued requests, then stop.
+  pthread_mutex_lock(&queue.lock);
+  queue.stop = 1;
+  pthread_cond_broadcast(&queue.ready);
+  pthread_mutex_unlock(&queue.lock);
+  for (int w = 0; w < workers; w++)
+    pthread_join(pool[w], NULL);
+  free(pool);
+  close(listener);
+  unlink(path);
+  return 0;
+}
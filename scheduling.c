@@ -5,17 +5,89 @@
          Firt Come First Served: FCFS
          Shortest-Job First: SJF
 
-  Scheduling on one CPU.
+         And of pre-emptive proportional-share algorithms:
+
+         Lottery scheduling
+         Stride scheduling
+         Round Robin: RR, and Multi-Level Feedback Queues: MLFQ
+
+         And of Earliest-Deadline First, pre-emptive or not: EDF
+
+  Scheduling on one CPU, or on several cores of different speeds and
+  maintenance outages. Jobs can depend on other jobs.
+
+  FCFS and SJF can also run on the packed form of a problem, on jobs
+  alternating CPU and I/O bursts, and on traces larger than the memory,
+  and FCFS on batches of small problems with SIMD.
+  Their waits can be estimated without simulation or by sampling, or
+  measured by running the jobs for real on worker threads. SJF can run on
+  predicted bursts, and the quantum of RR and MLFQ can be tuned.
 */
 
 #include "scheduling.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <limits.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCH_X86 1
+#endif
 
+#ifndef SCH_VERBOSE
 #define SCH_VERBOSE 1
+#endif
 #define TBL_ID 0
 #define TBL_ARRIVAL 1
 #define TBL_BURST 2
+#define TBL_TICKETS 3
+#define TBL_DEADLINE 4
+#define TBL_PROCESS 5
+#define TBL_COLUMNS 6
+
+#define STRIDE1 (1ULL << 30)
+
+/*
+  Binary min-heap of integers (usually a row index in the table). The
+  order is given by less, which receives the ctx of the heap.
+*/
+typedef struct {
+  int size;
+  int *items;
+  int (*less)(int a, int b, void *ctx);
+  void *ctx;
+} sch_heap;
+
+/*
+  A job read from a stream of jobs sorted by arrival time, then ID. The
+  source gives the next job and returns 0 at the end of the stream, the
+  sink is called with each job when it starts running.
+*/
+typedef struct {
+  int id;
+  int arrival;
+  int burst;
+} stream_job;
+
+typedef struct {
+  int (*next)(void *ctx, stream_job *job);
+  void *ctx;
+} job_source;
+
+typedef struct {
+  void (*dispatch)(void *ctx, stream_job *job, long long start);
+  void *ctx;
+} job_sink;
+
+typedef struct {
+  long long num;
+  long long wait_total;
+  long long cycle;
+} stream_result;
 
 void info_table(char *context, int num, int **table);
 void sort_sch_problem_asc(int num, int **table, int sort_by);
@@ -25,14 +97,44 @@ void sch_solution_malloc(sch_solution *sol);
 void queue_push_job(int curr_size, int **table, int *job);
 int* queue_poll_job(int curr_size, int **table);
 void execute_schedule(sch_problem *sch, sch_solution *sol, int sort_by_burst);
+void sch_table_sort(int num, int **table, int sort_by);
+unsigned long long rng_next(unsigned long long *state);
+void fenwick_add(long long *tree, int num, int pos, long long value);
+int fenwick_find(long long *tree, int num, long long value);
+void heap_push(sch_heap *heap, int item);
+int heap_pop(sch_heap *heap);
+void execute_lottery(sch_problem *sch, sch_solution *sol, int quantum, unsigned int seed);
+void execute_stride(sch_problem *sch, sch_solution *sol, int quantum);
+void execute_edf(sch_problem *sch, sch_solution *sol, int preemptive, sch_deadline_report *report);
+void execute_io(sch_io_problem *io, sch_solution *sol, int sort_by_burst, sch_io_report *report);
+void packed_put_varint(sch_packed_problem *pk, unsigned int value);
+unsigned int packed_get_varint(const unsigned char *data, long *pos);
+void execute_packed(sch_packed_problem *pk, sch_solution *sol, int sort_by_burst);
+stream_result execute_stream(job_source *src, job_sink *sink, int sort_by_burst,
+                             sch_arena *arena);
+int external_sort_runs(FILE *in, long records, FILE ***runs);
+int external_merge_passes(FILE ***runs, int num_runs, long records, int fan_in);
+int execute_dag(sch_problem *sch, sch_dag *dag, sch_solution *sol, int policy,
+                sch_dag_report *report);
+void execute_cores(sch_problem *sch, sch_solution *sol, int cores, int *speed,
+                   int placement, sch_outages *outages, int policy,
+                   sch_core_report *report);
+void execute_predicted(sch_problem *sch, sch_solution *sol, float *estimate,
+                       sch_predict_config *config, int oracle, double *error);
+void execute_mlfq(sch_problem *sch, sch_solution *sol, int levels, int quantum);
+int execute_admission(job_source *src, int sort_by_burst, sch_admission_config *config,
+                      sch_drop_callback drop, void *ctx, sch_admission_report *report);
 
 /**
   Allocate memory for the table in the scheduling problem structure sch in
-  parameter. It allocates the memory to hold a matrix of int sch->num x 3.
+  parameter. It allocates the memory to hold a matrix of int sch->num x TBL_COLUMNS.
   Each row i of the table holds the information about one job:
           sch->table[i][ID]      : i+1
           sch->table[i][ARRIVAL] : arrival time
           sch->table[i][BURST]   : burst time
+          sch->table[i][TICKETS] : 1
+          sch->table[i][DEADLINE]: NO_DEADLINE
+          sch->table[i][PROCESS] : 0
 
   @param sch the address of the scheduling problem;
        sch->num must already contain the number of jobs
@@ -41,7 +143,10 @@ void execute_schedule(sch_problem *sch, sch_solution *sol, int sort_by_burst);
 void sch_table_malloc(sch_problem *sch) {
   sch->table = (int**)malloc(sizeof(int*) * sch->num);
   for (int i = 0; i < sch->num; i++) {
-    sch->table[i] = (int*)malloc(sizeof(int) * 3);
+    sch->table[i] = (int*)malloc(sizeof(int) * TBL_COLUMNS);
+    sch->table[i][TBL_TICKETS] = 1;
+    sch->table[i][TBL_DEADLINE] = NO_DEADLINE;
+    sch->table[i][TBL_PROCESS] = 0;
   }
 }
 
@@ -155,6 +260,137 @@ sch_solution * sch_sjf(sch_problem *sch) {
   return sol;
 }
 
+/**
+   Compute the solution to a scheduling problem with Lottery scheduling.
+   Each quantum the CPU is given to a ready job drawn with probability
+   proportional to its TICKETS. The draws come from a generator seeded
+   with seed, so the same seed always gives the same solution.
+
+   @param sch the address of the scheduling problem to solve
+   @param quantum the number of cycles a job runs before the next draw
+   @param seed the seed of the random number generator
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_lottery(sch_problem *sch, int quantum, unsigned int seed) {
+  if(SCH_VERBOSE)
+    printf("*********** LOTTERY\n");
+  info_table("sch_lottery",sch->num,sch->table);
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_lottery(sch,sol,quantum,seed);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a scheduling problem with Stride scheduling.
+   Each quantum the CPU is given to the ready job with the lowest pass
+   value, which then advances by a stride inversely proportional to its
+   TICKETS. Break ties in favour of the job that arrived first.
+
+   @param sch the address of the scheduling problem to solve
+   @param quantum the number of cycles a job runs before the next choice
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_stride(sch_problem *sch, int quantum) {
+  if(SCH_VERBOSE)
+    printf("*********** STRIDE\n");
+  info_table("sch_stride",sch->num,sch->table);
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_stride(sch,sol,quantum);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a scheduling problem with Round Robin. The
+   ready jobs run in turn for quantum cycles each; the jobs arriving
+   during a turn are queued before the job that was running.
+
+   @param sch the address of the scheduling problem to solve
+   @param quantum the number of cycles of a turn
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_rr(sch_problem *sch, int quantum) {
+  return sch_mlfq(sch, 1, quantum);
+}
+
+/**
+   Compute the solution to a scheduling problem with a Multi-Level
+   Feedback Queue. Jobs arrive in level 0; a job using its whole quantum
+   goes down one level, down to level levels - 1. The turn goes to the
+   first job of the highest non-empty level, which runs for
+   quantum * 2^level cycles (a turn is not interrupted by arrivals).
+   Each level is Round Robin, and one level is sch_rr.
+
+   @param sch the address of the scheduling problem to solve
+   @param levels the number of levels
+   @param quantum the number of cycles of a turn in level 0
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_mlfq(sch_problem *sch, int levels, int quantum) {
+  if(SCH_VERBOSE)
+    printf("*********** %s\n", levels > 1 ? "MLFQ" : "RR");
+  info_table(levels > 1 ? "sch_mlfq" : "sch_rr",sch->num,sch->table);
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_mlfq(sch,sol,levels,quantum);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a scheduling problem with Earliest-Deadline
+   First scheduling: the ready job with the lowest DEADLINE runs first.
+   Break ties in favour of the job with lower ID.
+
+   @param sch the address of the scheduling problem to solve
+   @param preemptive if not 0, an arriving job with an earlier deadline
+          interrupts the running one
+   @param report the address where to store the deadline analysis,
+          or NULL. Free it with sch_deadline_report_free.
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_edf(sch_problem *sch, int preemptive, sch_deadline_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** EDF%s\n", preemptive ? " (pre-emptive)" : "");
+  info_table("sch_edf",sch->num,sch->table);
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_edf(sch,sol,preemptive,report);
+
+  return sol;
+}
+
+/**
+   Frees the arrays of a deadline report filled by sch_edf.
+
+   @param report the address of the report
+ */
+void sch_deadline_report_free(sch_deadline_report *report) {
+  free(report->finish);
+  free(report->tardiness);
+  free(report->missed_ids);
+}
+
 /**
    Prints the table of processes in a tabular form.
 
@@ -246,6 +482,7 @@ int get_no_of_jobs_waiting(int cycle, int next_job_id, int num, int **table) {
 void sch_solution_malloc(sch_solution *sol) {
   sol->order = (int*) malloc(sol->num * sizeof(int));
   sol->wait_average = 0.0;
+  sol->wait_total = 0;
 }
 
 /**
@@ -342,6 +579,7 @@ void execute_schedule(sch_problem *sch, sch_solution *sol, int sort_by_burst) {
       // We're actively working on a task
       burst--;
       wait_time += queue_size;
+      sol->wait_total += queue_size;
       cycle++;
     } else {
       if (queue_size == 0)
@@ -356,3 +594,4309 @@ void execute_schedule(sch_problem *sch, sch_solution *sol, int sort_by_burst) {
     sol->wait_average = wait_time / sch->num;
   }
 }
+
+/*
+  Entry of a sort by key, then ID, of the rows or jobs numbered index.
+  The entries carry their key since qsort passes no context to compare.
+*/
+typedef struct {
+  int key;
+  int id;
+  int index;
+} sort_entry;
+
+static int sort_entry_compare(const void *a, const void *b) {
+  const sort_entry *x = (const sort_entry*) a, *y = (const sort_entry*) b;
+  if (x->key != y->key)
+    return x->key < y->key ? -1 : 1;
+  if (x->id != y->id)
+    return x->id < y->id ? -1 : 1;
+  return 0;
+}
+
+/**
+   Sorts num entries by key then ID, and stores their index in that order.
+
+   @param num the number of entries
+   @param entries the entries, sorted in place
+   @param index the address where to store the num indices
+ */
+static void sort_entries(int num, sort_entry *entries, int *index) {
+  if (num > 1)
+    qsort(entries, num, sizeof(sort_entry), sort_entry_compare);
+  for (int i = 0; i < num; i++) {
+    index[i] = entries[i].index;
+  }
+}
+
+/**
+   Sorts the table like sort_sch_problem_asc, in O(n log n). Used by the
+   policies meant for large instances. Reentrant: the rows are sorted
+   through an array of entries carrying their key.
+
+   @param num the number of processes in the parameter table.
+   @param table the table of processes to sort.
+   @param sort_by is the id of the column that is used for sorting.
+ */
+void sch_table_sort(int num, int **table, int sort_by) {
+  if (num <= 1)
+    return;
+  sort_entry *entries = (sort_entry*) malloc(sizeof(sort_entry) * num);
+  int **rows = (int**) malloc(sizeof(int*) * num);
+  int *index = (int*) malloc(sizeof(int) * num);
+  for (int i = 0; i < num; i++) {
+    entries[i] = (sort_entry) { table[i][sort_by], table[i][TBL_ID], i };
+    rows[i] = table[i];
+  }
+  sort_entries(num, entries, index);
+  for (int i = 0; i < num; i++) {
+    table[i] = rows[index[i]];
+  }
+  free(entries);
+  free(rows);
+  free(index);
+}
+
+/**
+   Returns the next number of a xorshift64* generator and advances its state.
+   The state must not be 0.
+
+   @param state the address of the state of the generator
+ */
+unsigned long long rng_next(unsigned long long *state) {
+  unsigned long long x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+   Adds value to position pos (0-based) of a Fenwick tree of num elements.
+
+   @param tree the tree, an array of num+1 elements, tree[0] unused.
+ */
+void fenwick_add(long long *tree, int num, int pos, long long value) {
+  for (int i = pos + 1; i <= num; i += i & -i) {
+    tree[i] += value;
+  }
+}
+
+/**
+   Finds the position (0-based) of the element whose range of prefix sums
+   contains value, that is the first position whose prefix sum is greater
+   than value. value must be lower than the total of the tree.
+
+   @param tree the tree, an array of num+1 elements, tree[0] unused.
+ */
+int fenwick_find(long long *tree, int num, long long value) {
+  int pos = 0, step = 1;
+  while (step * 2 <= num) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    if (pos + step <= num && tree[pos + step] <= value) {
+      pos += step;
+      value -= tree[pos];
+    }
+  }
+  return pos;
+}
+
+/**
+   Adds an item to the heap. heap->items must have room for it.
+ */
+void heap_push(sch_heap *heap, int item) {
+  int i = heap->size++;
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (!heap->less(item, heap->items[parent], heap->ctx))
+      break;
+    heap->items[i] = heap->items[parent];
+    i = parent;
+  }
+  heap->items[i] = item;
+}
+
+/**
+   Removes and returns the smallest item of a non-empty heap.
+ */
+int heap_pop(sch_heap *heap) {
+  int top = heap->items[0];
+  int item = heap->items[--heap->size];
+  int i = 0;
+  while (2 * i + 1 < heap->size) {
+    int child = 2 * i + 1;
+    if (child + 1 < heap->size &&
+        heap->less(heap->items[child + 1], heap->items[child], heap->ctx))
+      child++;
+    if (!heap->less(heap->items[child], item, heap->ctx))
+      break;
+    heap->items[i] = heap->items[child];
+    i = child;
+  }
+  if (heap->size > 0)
+    heap->items[i] = item;
+  return top;
+}
+
+/**
+   Executes the schedule with lottery scheduling. The tickets of the ready
+   jobs are kept in a Fenwick tree indexed by their row, so drawing the
+   winner and removing a finished job take O(log n).
+   The order of completion and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param quantum is the maximum number of cycles between two draws
+   @param seed is the seed of the random number generator
+ */
+void execute_lottery(sch_problem *sch, sch_solution *sol, int quantum, unsigned int seed) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+  if (quantum < 1)
+    quantum = 1;
+
+  long long *tree = (long long*) calloc(sch->num + 1, sizeof(long long));
+  int *remaining = (int*) malloc(sizeof(int) * sch->num);
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+
+  int job_id = 0, order_id = 0, ready = 0;
+  long long cycle = 0, tickets = 0, wait_time = 0;
+  while(order_id < sch->num) {
+    while((job_id < sch->num) && (sch->table[job_id][TBL_ARRIVAL] <= cycle)) {
+      // Jobs with less than one ticket would never win, they get one.
+      int job_tickets = sch->table[job_id][TBL_TICKETS] > 0 ? sch->table[job_id][TBL_TICKETS] : 1;
+      fenwick_add(tree,sch->num,job_id,job_tickets);
+      tickets += job_tickets;
+      remaining[job_id] = sch->table[job_id][TBL_BURST];
+      ready++;
+      job_id++;
+    }
+
+    if (ready == 0) {
+      // Nothing to run, jump to the next arrival.
+      cycle = sch->table[job_id][TBL_ARRIVAL];
+      continue;
+    }
+
+    int winner = fenwick_find(tree,sch->num,(long long)(rng_next(&state) % tickets));
+    int *job = sch->table[winner];
+    int slice = remaining[winner] < quantum ? remaining[winner] : quantum;
+    if (SCH_VERBOSE) {
+      printf("(  %lld) Running job %d for %d, with %d tickets.\n",
+        cycle, job[TBL_ID], slice, job[TBL_TICKETS]);
+    }
+    cycle += slice;
+    remaining[winner] -= slice;
+
+    if (remaining[winner] <= 0) {
+      int job_tickets = job[TBL_TICKETS] > 0 ? job[TBL_TICKETS] : 1;
+      fenwick_add(tree,sch->num,winner,-job_tickets);
+      tickets -= job_tickets;
+      ready--;
+      wait_time += cycle - job[TBL_ARRIVAL] - job[TBL_BURST];
+      sol->order[order_id] = job[TBL_ID];
+      order_id++;
+    }
+  }
+
+  free(tree);
+  free(remaining);
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+}
+
+/*
+  Context of the heap of ready jobs for stride scheduling.
+*/
+typedef struct {
+  unsigned long long *pass;
+} stride_ctx;
+
+static int stride_less(int a, int b, void *ctx) {
+  unsigned long long *pass = ((stride_ctx*) ctx)->pass;
+  if (pass[a] != pass[b])
+    return pass[a] < pass[b];
+  return a < b;
+}
+
+/**
+   Executes the schedule with stride scheduling. The ready jobs are kept
+   in a heap ordered by pass value, so picking the next job takes O(log n).
+   A job joining the ready jobs starts one stride after the global pass,
+   which advances as if all ready tickets shared the CPU.
+   The order of completion and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param quantum is the maximum number of cycles between two choices
+ */
+void execute_stride(sch_problem *sch, sch_solution *sol, int quantum) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+  if (quantum < 1)
+    quantum = 1;
+
+  unsigned long long *pass = (unsigned long long*) malloc(sizeof(unsigned long long) * sch->num);
+  unsigned long long *stride = (unsigned long long*) malloc(sizeof(unsigned long long) * sch->num);
+  int *remaining = (int*) malloc(sizeof(int) * sch->num);
+  stride_ctx ctx = { pass };
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * sch->num), stride_less, &ctx };
+
+  int job_id = 0, order_id = 0;
+  long long cycle = 0, tickets = 0, wait_time = 0;
+  unsigned long long global_pass = 0;
+  while(order_id < sch->num) {
+    while((job_id < sch->num) && (sch->table[job_id][TBL_ARRIVAL] <= cycle)) {
+      int job_tickets = sch->table[job_id][TBL_TICKETS] > 0 ? sch->table[job_id][TBL_TICKETS] : 1;
+      stride[job_id] = STRIDE1 / job_tickets;
+      pass[job_id] = global_pass + stride[job_id];
+      tickets += job_tickets;
+      remaining[job_id] = sch->table[job_id][TBL_BURST];
+      heap_push(&ready,job_id);
+      job_id++;
+    }
+
+    if (ready.size == 0) {
+      cycle = sch->table[job_id][TBL_ARRIVAL];
+      continue;
+    }
+
+    int next = heap_pop(&ready);
+    int *job = sch->table[next];
+    int slice = remaining[next] < quantum ? remaining[next] : quantum;
+    if (SCH_VERBOSE) {
+      printf("(  %lld) Running job %d for %d, with %d tickets.\n",
+        cycle, job[TBL_ID], slice, job[TBL_TICKETS]);
+    }
+    cycle += slice;
+    remaining[next] -= slice;
+    global_pass += STRIDE1 / tickets * slice / quantum;
+
+    if (remaining[next] > 0) {
+      pass[next] += stride[next] * slice / quantum;
+      heap_push(&ready,next);
+    } else {
+      tickets -= job[TBL_TICKETS] > 0 ? job[TBL_TICKETS] : 1;
+      wait_time += cycle - job[TBL_ARRIVAL] - job[TBL_BURST];
+      sol->order[order_id] = job[TBL_ID];
+      order_id++;
+    }
+  }
+
+  free(pass);
+  free(stride);
+  free(remaining);
+  free(ready.items);
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+}
+
+/*
+  Zigzag encoding maps signed values to unsigned ones so that small
+  negative numbers also get a short varint.
+*/
+static unsigned int zigzag(int value) {
+  return ((unsigned int) value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int unzigzag(unsigned int value) {
+  return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+/**
+   Allocates an empty packed scheduling problem.
+
+   @return the address of the packed problem
+ */
+sch_packed_problem * sch_packed_malloc() {
+  sch_packed_problem *pk = (sch_packed_problem*) malloc(sizeof(sch_packed_problem));
+  pk->num = 0;
+  pk->size = 0;
+  pk->capacity = 64;
+  pk->data = (unsigned char*) malloc(pk->capacity);
+  pk->last_arrival = 0;
+  pk->last_id = 0;
+  return pk;
+}
+
+/**
+   Frees a packed scheduling problem and its data.
+
+   @param pk the address of the packed problem
+ */
+void sch_packed_free(sch_packed_problem *pk) {
+  free(pk->data);
+  free(pk);
+}
+
+/**
+   Appends value to the data of pk as a varint: 7 bits per byte, the high
+   bit set on every byte but the last. The data grows by doubling.
+ */
+void packed_put_varint(sch_packed_problem *pk, unsigned int value) {
+  if (pk->size + 5 > pk->capacity) {
+    pk->capacity *= 2;
+    pk->data = (unsigned char*) realloc(pk->data, pk->capacity);
+  }
+  while (value >= 0x80) {
+    pk->data[pk->size++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  pk->data[pk->size++] = (unsigned char) value;
+}
+
+/**
+   Reads the varint at data[*pos] and moves *pos after it.
+ */
+unsigned int packed_get_varint(const unsigned char *data, long *pos) {
+  unsigned int value = 0;
+  int shift = 0;
+  while (data[*pos] & 0x80) {
+    value |= (unsigned int)(data[(*pos)++] & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= (unsigned int) data[(*pos)++] << shift;
+  return value;
+}
+
+/**
+   Appends a job to a packed problem. Jobs must be appended sorted by
+   arrival time, and by ID for equal arrival times, so that a trace can be
+   packed while it is read without building the table first. The arrival
+   must not be negative: the packed engines start at cycle 0 like
+   execute_schedule, and the deltas then always fit in an int.
+
+   @param pk the address of the packed problem
+   @param id the ID of the job
+   @param arrival the arrival time of the job
+   @param burst the burst time of the job
+
+   @return 1 if the job was appended, 0 if it breaks the order or arrives
+           before cycle 0
+ */
+int sch_packed_append(sch_packed_problem *pk, int id, int arrival, int burst) {
+  if (arrival < 0)
+    return 0;
+  if (pk->num > 0 && (arrival < pk->last_arrival ||
+      (arrival == pk->last_arrival && id < pk->last_id))) {
+    return 0;
+  }
+  if (pk->num == 0) {
+    packed_put_varint(pk, zigzag(arrival));
+  } else {
+    packed_put_varint(pk, (unsigned int) arrival - (unsigned int) pk->last_arrival);
+  }
+  packed_put_varint(pk, zigzag(id));
+  packed_put_varint(pk, zigzag(burst));
+  pk->last_arrival = arrival;
+  pk->last_id = id;
+  pk->num++;
+  return 1;
+}
+
+/**
+   Builds the packed form of a scheduling problem. The table of sch is
+   sorted by arrival time in place.
+
+   @param sch the address of the scheduling problem to pack
+
+   @return the address of the packed problem, or NULL if a job arrives
+           before cycle 0
+ */
+sch_packed_problem * sch_pack(sch_problem *sch) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+  sch_packed_problem *pk = sch_packed_malloc();
+  for (int i = 0; i < sch->num; i++) {
+    if (!sch_packed_append(pk, sch->table[i][TBL_ID],
+          sch->table[i][TBL_ARRIVAL], sch->table[i][TBL_BURST])) {
+      sch_packed_free(pk);
+      return NULL;
+    }
+  }
+  return pk;
+}
+
+/**
+   Compute the solution to a packed scheduling problem with First Come
+   First Served scheduling. Same as sch_fcfs.
+
+   @param pk the address of the packed problem to solve
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_fcfs_packed(sch_packed_problem *pk) {
+  if(SCH_VERBOSE)
+    printf("*********** FCFS (packed)\n");
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = pk->num;
+  sch_solution_malloc(sol);
+
+  execute_packed(pk,sol,0 /* false */);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a packed scheduling problem with Shortest Job
+   First scheduling. Same as sch_sjf.
+
+   @param pk the address of the packed problem to solve
+
+   @return the address of the computer scheduling solution
+ */
+sch_solution * sch_sjf_packed(sch_packed_problem *pk) {
+  if(SCH_VERBOSE)
+    printf("*********** SJF (packed)\n");
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = pk->num;
+  sch_solution_malloc(sol);
+
+  execute_packed(pk,sol,1 /* true */);
+
+  return sol;
+}
+
+static int stream_sjf_less(int a, int b, void *ctx) {
+  stream_job *jobs = (stream_job*) ctx;
+  if (jobs[a].burst != jobs[b].burst)
+    return jobs[a].burst < jobs[b].burst;
+  return jobs[a].id < jobs[b].id;
+}
+
+/*
+  Buffers of execute_stream, kept between calls by sch_solve_jobs: the
+  ready jobs with their heap and free slots, and the jobs sorted by
+  arrival time.
+*/
+struct sch_arena {
+  int capacity;
+  stream_job *jobs;
+  int *free_slots;
+  int *heap;
+  int sorted_capacity;
+  stream_job *sorted;
+};
+
+/**
+   Executes the schedule of the jobs read from src, which must give them
+   sorted by arrival time then ID. FCFS runs the jobs in that order and
+   needs no queue. SJF keeps the ready jobs in a heap ordered by burst
+   time then ID, whose slots are recycled, so only the ready jobs are ever
+   in memory. Each job is passed to sink when it starts.
+   The results are the same as execute_schedule.
+
+   @param src is the source of the jobs to schedule
+   @param sink is called with each job and the cycle it starts at
+   @param sort_by_burst is used to use the FCFS or SJF algorithms.
+   @param arena holds the buffers to reuse, they are grown if needed;
+          NULL to allocate them for this call only
+
+   @return the number of jobs, the total wait and the last cycle
+ */
+stream_result execute_stream(job_source *src, job_sink *sink, int sort_by_burst,
+                             sch_arena *arena) {
+  stream_result res = { 0, 0, 0 };
+  sch_arena local = { 0, NULL, NULL, NULL, 0, NULL };
+  if (arena == NULL)
+    arena = &local;
+
+  // SJF only: ready jobs, their heap and the stack of free slots.
+  int free_size = 0;
+  sch_heap ready = { 0, arena->heap, stream_sjf_less, arena->jobs };
+
+  stream_job next, job;
+  int has_next = src->next(src->ctx, &next);
+  while (1) {
+    if (!sort_by_burst) {
+      if (!has_next)
+        break;
+      job = next;
+      has_next = src->next(src->ctx, &next);
+      if (res.cycle < job.arrival)
+        res.cycle = job.arrival;
+    } else {
+      if (ready.size == 0) {
+        if (!has_next)
+          break;
+        // Nothing ready, jump to the next arrival.
+        if (res.cycle < next.arrival)
+          res.cycle = next.arrival;
+      }
+      while (has_next && next.arrival <= res.cycle) {
+        int slot;
+        if (free_size > 0) {
+          slot = arena->free_slots[--free_size];
+        } else {
+          if (ready.size == arena->capacity) {
+            arena->capacity = arena->capacity > 0 ? arena->capacity * 2 : 16;
+            arena->jobs = (stream_job*) realloc(arena->jobs, sizeof(stream_job) * arena->capacity);
+            arena->free_slots = (int*) realloc(arena->free_slots, sizeof(int) * arena->capacity);
+            arena->heap = (int*) realloc(arena->heap, sizeof(int) * arena->capacity);
+            ready.items = arena->heap;
+            ready.ctx = arena->jobs;
+          }
+          slot = ready.size;
+        }
+        arena->jobs[slot] = next;
+        heap_push(&ready, slot);
+        has_next = src->next(src->ctx, &next);
+      }
+      int slot = heap_pop(&ready);
+      arena->free_slots[free_size++] = slot;
+      job = arena->jobs[slot];
+    }
+
+    if (SCH_VERBOSE) {
+      printf("(  %lld) Running job %d, arrived at %d, with burst time %d.\n",
+        res.cycle, job.id, job.arrival, job.burst);
+    }
+    sink->dispatch(sink->ctx, &job, res.cycle);
+    res.wait_total += res.cycle - job.arrival;
+    res.cycle += job.burst;
+    res.num++;
+  }
+
+  if (arena == &local) {
+    free(local.jobs);
+    free(local.free_slots);
+    free(local.heap);
+  }
+  return res;
+}
+
+/*
+  Position of the decoder of a packed problem.
+*/
+typedef struct {
+  sch_packed_problem *pk;
+  long pos;
+  int decoded;
+  int arrival;
+} packed_reader;
+
+static int packed_next(void *ctx, stream_job *job) {
+  packed_reader *rd = (packed_reader*) ctx;
+  if (rd->decoded == rd->pk->num)
+    return 0;
+  unsigned int arrival = packed_get_varint(rd->pk->data, &rd->pos);
+  // in unsigned arithmetic, like the encoder
+  rd->arrival = rd->decoded == 0 ? unzigzag(arrival)
+                                 : (int) ((unsigned int) rd->arrival + arrival);
+  job->arrival = rd->arrival;
+  job->id = unzigzag(packed_get_varint(rd->pk->data, &rd->pos));
+  job->burst = unzigzag(packed_get_varint(rd->pk->data, &rd->pos));
+  rd->decoded++;
+  return 1;
+}
+
+/*
+  Sink storing the order of the jobs in a solution.
+*/
+typedef struct {
+  sch_solution *sol;
+  int order_id;
+} order_writer;
+
+static void order_dispatch(void *ctx, stream_job *job, long long start) {
+  order_writer *wr = (order_writer*) ctx;
+  (void) start;
+  wr->sol->order[wr->order_id++] = job->id;
+}
+
+/**
+   Executes the schedule of a packed problem, decoding the jobs as they
+   arrive. See execute_stream.
+
+   @param pk is the packed problem containing all the processes to schedule
+   @param sol is the solution that will be storing the execution order and avg. wait time
+   @param sort_by_burst is used to use the FCFS or SJF algorithms.
+ */
+void execute_packed(sch_packed_problem *pk, sch_solution *sol, int sort_by_burst) {
+  packed_reader rd = { pk, 0, 0, 0 };
+  job_source src = { packed_next, &rd };
+  order_writer wr = { sol, 0 };
+  job_sink sink = { order_dispatch, &wr };
+
+  stream_result res = execute_stream(&src, &sink, sort_by_burst, NULL);
+
+  sol->wait_total = res.wait_total;
+  if (pk->num > 0) {
+    sol->wait_average = (double) res.wait_total / pk->num;
+  }
+}
+
+static int edf_less(int a, int b, void *ctx) {
+  int **table = (int**) ctx;
+  if (table[a][TBL_DEADLINE] != table[b][TBL_DEADLINE])
+    return table[a][TBL_DEADLINE] < table[b][TBL_DEADLINE];
+  return table[a][TBL_ID] < table[b][TBL_ID];
+}
+
+/**
+   Executes the schedule with EDF. The ready jobs are kept in a heap
+   ordered by deadline, and the simulation jumps from event to event (an
+   arrival or the end of a job) instead of going through every cycle.
+   The order of completion and avg. wait time are stored in sol, the
+   finish times and deadline misses in report if it is not NULL.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param preemptive is used to let arriving jobs interrupt the running one
+   @param report is the deadline report to fill, or NULL
+ */
+void execute_edf(sch_problem *sch, sch_solution *sol, int preemptive, sch_deadline_report *report) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+
+  int *remaining = (int*) malloc(sizeof(int) * sch->num);
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * sch->num), edf_less, sch->table };
+  if (report != NULL) {
+    report->num = sch->num;
+    report->finish = (long long*) malloc(sizeof(long long) * sch->num);
+    report->tardiness = (long long*) malloc(sizeof(long long) * sch->num);
+    report->missed_ids = (int*) malloc(sizeof(int) * sch->num);
+    report->missed = 0;
+    report->max_lateness = 0;
+  }
+
+  int job_id = 0, order_id = 0, with_deadline = 0;
+  long long cycle = 0, wait_time = 0;
+  while(order_id < sch->num) {
+    while((job_id < sch->num) && (sch->table[job_id][TBL_ARRIVAL] <= cycle)) {
+      remaining[job_id] = sch->table[job_id][TBL_BURST];
+      heap_push(&ready,job_id);
+      job_id++;
+    }
+
+    if (ready.size == 0) {
+      cycle = sch->table[job_id][TBL_ARRIVAL];
+      continue;
+    }
+
+    int next = heap_pop(&ready);
+    int *job = sch->table[next];
+    // A pre-emptive job only runs until the next arrival, then competes again.
+    long long slice = remaining[next];
+    if (preemptive && job_id < sch->num && sch->table[job_id][TBL_ARRIVAL] - cycle < slice) {
+      slice = sch->table[job_id][TBL_ARRIVAL] - cycle;
+    }
+    if (SCH_VERBOSE && slice > 0) {
+      printf("(  %lld) Running job %d for %lld, with deadline %d.\n",
+        cycle, job[TBL_ID], slice, job[TBL_DEADLINE]);
+    }
+    cycle += slice;
+    remaining[next] -= slice;
+
+    if (remaining[next] > 0) {
+      heap_push(&ready,next);
+      continue;
+    }
+
+    wait_time += cycle - job[TBL_ARRIVAL] - job[TBL_BURST];
+    sol->order[order_id] = job[TBL_ID];
+    if (report != NULL) {
+      long long lateness = cycle - job[TBL_DEADLINE];
+      report->finish[order_id] = cycle;
+      report->tardiness[order_id] = 0;
+      if (job[TBL_DEADLINE] != NO_DEADLINE) {
+        if (with_deadline == 0 || lateness > report->max_lateness)
+          report->max_lateness = lateness;
+        with_deadline++;
+        if (lateness > 0) {
+          report->tardiness[order_id] = lateness;
+          report->missed_ids[report->missed] = job[TBL_ID];
+          report->missed++;
+          if (SCH_VERBOSE) {
+            printf("(  %lld) Job %d missed its deadline %d by %lld.\n",
+              cycle, job[TBL_ID], job[TBL_DEADLINE], lateness);
+          }
+        }
+      }
+    }
+    order_id++;
+  }
+
+  free(remaining);
+  free(ready.items);
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+}
+
+/**
+   Allocates a problem of jobs with CPU and I/O bursts. The arrays are
+   left for the caller to fill.
+
+   @param num the number of jobs
+   @param phases the total number of bursts of all the jobs
+   @param devices the number of I/O devices
+
+   @return the address of the problem
+ */
+sch_io_problem * sch_io_problem_malloc(int num, int phases, int devices) {
+  sch_io_problem *io = (sch_io_problem*) malloc(sizeof(sch_io_problem));
+  io->num = num;
+  io->phases = phases;
+  io->devices = devices;
+  io->id = (int*) malloc(sizeof(int) * num);
+  io->arrival = (int*) malloc(sizeof(int) * num);
+  io->first_phase = (int*) malloc(sizeof(int) * (num + 1));
+  io->phase_length = (int*) malloc(sizeof(int) * phases);
+  io->phase_device = (int*) malloc(sizeof(int) * phases);
+  io->first_phase[0] = 0;
+  return io;
+}
+
+/**
+   Frees a problem of jobs with CPU and I/O bursts.
+
+   @param io the address of the problem
+ */
+void sch_io_problem_free(sch_io_problem *io) {
+  free(io->id);
+  free(io->arrival);
+  free(io->first_phase);
+  free(io->phase_length);
+  free(io->phase_device);
+  free(io);
+}
+
+/**
+   Frees the arrays of a report filled by sch_fcfs_io or sch_sjf_io.
+
+   @param report the address of the report
+ */
+void sch_io_report_free(sch_io_report *report) {
+  free(report->busy);
+  free(report->wait);
+  free(report->utilization);
+}
+
+/**
+   Checks that the phases of the jobs are within the problem and run on
+   the CPU or on one of its devices.
+
+   @return 1 if the problem is valid, 0 otherwise
+ */
+static int io_problem_valid(sch_io_problem *io) {
+  if (io->num < 0 || io->devices < 0 || io->first_phase[0] != 0 ||
+      io->first_phase[io->num] > io->phases)
+    return 0;
+  for (int i = 0; i < io->num; i++) {
+    if (io->first_phase[i + 1] < io->first_phase[i])
+      return 0;
+  }
+  for (int p = 0; p < io->first_phase[io->num]; p++) {
+    if (io->phase_device[p] != IO_CPU &&
+        (io->phase_device[p] < 0 || io->phase_device[p] >= io->devices))
+      return 0;
+  }
+  return 1;
+}
+
+/**
+   Compute the solution to a problem of jobs with CPU and I/O bursts,
+   with First Come First Served on the CPU. The devices always serve
+   their queue in order of arrival.
+
+   @param io the address of the problem to solve
+   @param report the address where to store the use of each resource,
+          or NULL. Free it with sch_io_report_free.
+
+   @return the address of the computer scheduling solution, the order is
+           the order of completion and the wait is the one on the CPU;
+           NULL if a phase runs on a device the problem does not have
+ */
+sch_solution * sch_fcfs_io(sch_io_problem *io, sch_io_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** FCFS (I/O)\n");
+  if (!io_problem_valid(io))
+    return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = io->num;
+  sch_solution_malloc(sol);
+
+  execute_io(io,sol,0 /* false */,report);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a problem of jobs with CPU and I/O bursts,
+   with Shortest Job First on the CPU, by the length of the next CPU
+   burst. The devices always serve their queue in order of arrival.
+
+   @param io the address of the problem to solve
+   @param report the address where to store the use of each resource,
+          or NULL. Free it with sch_io_report_free.
+
+   @return the address of the computer scheduling solution, the order is
+           the order of completion and the wait is the one on the CPU;
+           NULL if a phase runs on a device the problem does not have
+ */
+sch_solution * sch_sjf_io(sch_io_problem *io, sch_io_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** SJF (I/O)\n");
+  if (!io_problem_valid(io))
+    return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = io->num;
+  sch_solution_malloc(sol);
+
+  execute_io(io,sol,1 /* true */,report);
+
+  return sol;
+}
+
+/*
+  State of the simulation of a sch_io_problem. Every array is allocated
+  once, jobs waiting for a device are chained through next.
+*/
+typedef struct {
+  sch_io_problem *io;
+  int *phase;          // current phase of each job
+  long long *queued_at;
+  int *next;           // next job in the same device queue
+  int *head, *tail;    // queue of each resource (CPU only for FCFS)
+  int *running;        // job on each resource, or -1
+  long long *done_at;  // end of the burst on each resource
+  int *to_dispatch;    // idle resources that got a job
+  char *marked;
+  int dispatch_size;
+  sch_heap cpu_ready;  // SJF only
+  sch_heap events;     // busy resources by done_at
+  int sort_by_burst;
+} io_state;
+
+static int io_cpu_less(int a, int b, void *ctx) {
+  io_state *st = (io_state*) ctx;
+  int len_a = st->io->phase_length[st->phase[a]];
+  int len_b = st->io->phase_length[st->phase[b]];
+  if (len_a != len_b)
+    return len_a < len_b;
+  return st->io->id[a] < st->io->id[b];
+}
+
+static int io_event_less(int a, int b, void *ctx) {
+  io_state *st = (io_state*) ctx;
+  if (st->done_at[a] != st->done_at[b])
+    return st->done_at[a] < st->done_at[b];
+  return a < b;
+}
+
+/**
+   Puts job in the queue of the resource of its current phase, at cycle.
+ */
+static void io_enqueue(io_state *st, int job, long long cycle) {
+  int device = st->io->phase_device[st->phase[job]];
+  int r = device == IO_CPU ? 0 : device + 1;
+  st->queued_at[job] = cycle;
+  if (r == 0 && st->sort_by_burst) {
+    heap_push(&st->cpu_ready, job);
+  } else {
+    st->next[job] = -1;
+    if (st->head[r] == -1)
+      st->head[r] = job;
+    else
+      st->next[st->tail[r]] = job;
+    st->tail[r] = job;
+  }
+  if (st->running[r] == -1 && !st->marked[r]) {
+    st->marked[r] = 1;
+    st->to_dispatch[st->dispatch_size++] = r;
+  }
+}
+
+/**
+   Executes the schedule of jobs with CPU and I/O bursts. Each resource
+   serves one job at a time from its own queue. The simulation jumps from
+   event to event: an arrival, or the end of a burst on a resource, kept
+   in a heap. No memory is allocated once it started.
+   At the same cycle, bursts end before jobs arrive and the CPU before
+   the devices.
+
+   @param io is the problem containing all the jobs to schedule
+   @param sol is the solution that will be storing the order and avg. CPU wait time
+   @param sort_by_burst is used to use the FCFS or SJF algorithms on the CPU
+   @param report is the resource report to fill, or NULL
+ */
+void execute_io(sch_io_problem *io, sch_solution *sol, int sort_by_burst, sch_io_report *report) {
+  int n = io->num, resources = io->devices + 1;
+  io_state st;
+  st.io = io;
+  st.sort_by_burst = sort_by_burst;
+  st.phase = (int*) malloc(sizeof(int) * n);
+  st.queued_at = (long long*) malloc(sizeof(long long) * n);
+  st.next = (int*) malloc(sizeof(int) * n);
+  st.head = (int*) malloc(sizeof(int) * resources);
+  st.tail = (int*) malloc(sizeof(int) * resources);
+  st.running = (int*) malloc(sizeof(int) * resources);
+  st.done_at = (long long*) malloc(sizeof(long long) * resources);
+  st.to_dispatch = (int*) malloc(sizeof(int) * resources);
+  st.marked = (char*) calloc(resources, sizeof(char));
+  st.dispatch_size = 0;
+  st.cpu_ready = (sch_heap) { 0, (int*) malloc(sizeof(int) * n), io_cpu_less, &st };
+  st.events = (sch_heap) { 0, (int*) malloc(sizeof(int) * resources), io_event_less, &st };
+  long long *busy = (long long*) calloc(resources, sizeof(long long));
+  long long *wait = (long long*) calloc(resources, sizeof(long long));
+  for (int r = 0; r < resources; r++) {
+    st.head[r] = -1;
+    st.running[r] = -1;
+  }
+
+  // Jobs by arrival time, then ID.
+  int *by_arrival = (int*) malloc(sizeof(int) * n);
+  sort_entry *entries = (sort_entry*) malloc(sizeof(sort_entry) * (n > 0 ? n : 1));
+  for (int i = 0; i < n; i++) {
+    entries[i] = (sort_entry) { io->arrival[i], io->id[i], i };
+  }
+  sort_entries(n, entries, by_arrival);
+  free(entries);
+
+  int arrived = 0, order_id = 0;
+  long long cycle = 0;
+  while (order_id < n) {
+    if (st.events.size > 0 && st.done_at[st.events.items[0]] <= cycle) {
+      // End of a burst: the job moves to its next phase.
+      int r = heap_pop(&st.events);
+      int job = st.running[r];
+      st.running[r] = -1;
+      if (st.head[r] != -1 || (r == 0 && st.cpu_ready.size > 0)) {
+        st.marked[r] = 1;
+        st.to_dispatch[st.dispatch_size++] = r;
+      }
+      st.phase[job]++;
+      if (st.phase[job] < io->first_phase[job + 1]) {
+        io_enqueue(&st, job, cycle);
+      } else {
+        sol->order[order_id++] = io->id[job];
+      }
+      continue;
+    }
+
+    if (arrived < n && io->arrival[by_arrival[arrived]] <= cycle) {
+      int job = by_arrival[arrived++];
+      st.phase[job] = io->first_phase[job];
+      if (st.phase[job] < io->first_phase[job + 1]) {
+        io_enqueue(&st, job, cycle);
+      } else {
+        sol->order[order_id++] = io->id[job];
+      }
+      continue;
+    }
+
+    if (st.dispatch_size > 0) {
+      // Start the next burst on an idle resource.
+      int r = st.to_dispatch[--st.dispatch_size];
+      st.marked[r] = 0;
+      int job;
+      if (r == 0 && sort_by_burst) {
+        job = heap_pop(&st.cpu_ready);
+      } else {
+        job = st.head[r];
+        st.head[r] = st.next[job];
+      }
+      int length = io->phase_length[st.phase[job]];
+      if (SCH_VERBOSE) {
+        if (r == 0)
+          printf("(  %lld) Running job %d on the CPU for %d.\n", cycle, io->id[job], length);
+        else
+          printf("(  %lld) Running job %d on device %d for %d.\n", cycle, io->id[job], r - 1, length);
+      }
+      wait[r] += cycle - st.queued_at[job];
+      busy[r] += length;
+      st.running[r] = job;
+      st.done_at[r] = cycle + length;
+      heap_push(&st.events, r);
+      continue;
+    }
+
+    // Nothing left at this cycle, jump to the next event.
+    long long next_cycle = -1;
+    if (arrived < n)
+      next_cycle = io->arrival[by_arrival[arrived]];
+    if (st.events.size > 0 && (next_cycle < 0 || st.done_at[st.events.items[0]] < next_cycle))
+      next_cycle = st.done_at[st.events.items[0]];
+    if (SCH_VERBOSE && st.running[0] == -1 && order_id < n) {
+      printf("(  %lld) No job ready.\n", cycle);
+    }
+    cycle = next_cycle;
+  }
+
+  sol->wait_total = wait[0];
+  if (n > 0) {
+    sol->wait_average = (double) wait[0] / n;
+  }
+  if (report != NULL) {
+    report->resources = resources;
+    report->busy = busy;
+    report->wait = wait;
+    report->makespan = cycle;
+    report->utilization = (float*) malloc(sizeof(float) * resources);
+    for (int r = 0; r < resources; r++) {
+      report->utilization[r] = cycle > 0 ? (double) busy[r] / cycle : 0.0;
+    }
+  } else {
+    free(busy);
+    free(wait);
+  }
+
+  free(by_arrival);
+  free(st.phase);
+  free(st.queued_at);
+  free(st.next);
+  free(st.head);
+  free(st.tail);
+  free(st.running);
+  free(st.done_at);
+  free(st.to_dispatch);
+  free(st.marked);
+  free(st.cpu_ready.items);
+  free(st.events.items);
+}
+
+#define EXT_MIN_RECORDS 16
+
+static int stream_job_compare(const void *a, const void *b) {
+  const stream_job *job_a = (const stream_job*) a;
+  const stream_job *job_b = (const stream_job*) b;
+  if (job_a->arrival != job_b->arrival)
+    return job_a->arrival < job_b->arrival ? -1 : 1;
+  if (job_a->id != job_b->id)
+    return job_a->id < job_b->id ? -1 : 1;
+  return 0;
+}
+
+/**
+   Writes the jobs of a scheduling problem to a trace file.
+
+   @param path the path of the trace file
+   @param sch the address of the scheduling problem
+
+   @return 1 if the trace was written, 0 otherwise
+ */
+int sch_trace_write(const char *path, sch_problem *sch) {
+  FILE *out = fopen(path, "wb");
+  if (out == NULL)
+    return 0;
+  int ok = 1;
+  for (int i = 0; i < sch->num && ok; i++) {
+    stream_job job = { sch->table[i][TBL_ID], sch->table[i][TBL_ARRIVAL], sch->table[i][TBL_BURST] };
+    ok = fwrite(&job, sizeof(stream_job), 1, out) == 1;
+  }
+  return fclose(out) == 0 && ok;
+}
+
+/*
+  A sorted run of an external sort, read through a buffer.
+*/
+typedef struct {
+  FILE *file;
+  stream_job *buffer;
+  int capacity;
+  int size;
+  int pos;
+} ext_run;
+
+typedef struct {
+  ext_run *runs;
+  sch_heap heap;  // runs by their current job
+} ext_merger;
+
+static int ext_run_less(int a, int b, void *ctx) {
+  ext_run *runs = (ext_run*) ctx;
+  return stream_job_compare(&runs[a].buffer[runs[a].pos], &runs[b].buffer[runs[b].pos]) < 0;
+}
+
+/**
+   Moves a run to its next job, reading the next buffer when needed.
+
+   @return 1 if the run has a current job, 0 at its end
+ */
+static int ext_run_advance(ext_run *run) {
+  run->pos++;
+  if (run->pos >= run->size) {
+    run->size = fread(run->buffer, sizeof(stream_job), run->capacity, run->file);
+    run->pos = 0;
+  }
+  return run->pos < run->size;
+}
+
+static int ext_merge_next(void *ctx, stream_job *job) {
+  ext_merger *mg = (ext_merger*) ctx;
+  if (mg->heap.size == 0)
+    return 0;
+  int r = heap_pop(&mg->heap);
+  ext_run *run = &mg->runs[r];
+  *job = run->buffer[run->pos];
+  if (ext_run_advance(run))
+    heap_push(&mg->heap, r);
+  return 1;
+}
+
+static void ext_output_dispatch(void *ctx, stream_job *job, long long start) {
+  fprintf((FILE*) ctx, "%d %lld %lld\n", job->id, start, start - job->arrival);
+}
+
+/**
+   Opens a temporary file for a run, without a stdio buffer: the runs are
+   read and written through the buffers counted in the memory budget.
+
+   @return the file, deleted when it is closed, or NULL on error
+ */
+static FILE * ext_run_file() {
+  FILE *file = tmpfile();
+  if (file != NULL)
+    setvbuf(file, NULL, _IONBF, 0);
+  return file;
+}
+
+/**
+   Splits a trace into sorted runs: reads records by chunks of records,
+   sorts each chunk by arrival time then ID and writes it to a temporary
+   file, deleted when it is closed.
+
+   @param in the trace file
+   @param records the number of records sorted at once
+   @param runs the address where to store the array of runs, rewound
+
+   @return the number of runs, -1 on error, reading the trace included
+ */
+int external_sort_runs(FILE *in, long records, FILE ***runs) {
+  stream_job *buffer = (stream_job*) malloc(sizeof(stream_job) * records);
+  int num_runs = 0, capacity = 8;
+  *runs = (FILE**) malloc(sizeof(FILE*) * capacity);
+  size_t read;
+  while ((read = fread(buffer, sizeof(stream_job), records, in)) > 0) {
+    qsort(buffer, read, sizeof(stream_job), stream_job_compare);
+    FILE *run = ext_run_file();
+    if (run == NULL || fwrite(buffer, sizeof(stream_job), read, run) != read) {
+      if (run != NULL)
+        fclose(run);
+      break;
+    }
+    rewind(run);
+    if (num_runs == capacity) {
+      capacity *= 2;
+      *runs = (FILE**) realloc(*runs, sizeof(FILE*) * capacity);
+    }
+    (*runs)[num_runs++] = run;
+  }
+  free(buffer);
+  // a read error would otherwise look like the end of the trace
+  if (ferror(in) || !feof(in)) {
+    for (int r = 0; r < num_runs; r++)
+      fclose((*runs)[r]);
+    free(*runs);
+    return -1;
+  }
+  return num_runs;
+}
+
+/**
+   Starts a merge of num_runs runs with buffers of per_run records.
+
+   @param mg the merger to fill, with room for num_runs runs
+   @param files the runs, rewound
+ */
+static void ext_merge_start(ext_merger *mg, FILE **files, int num_runs, long per_run) {
+  for (int r = 0; r < num_runs; r++) {
+    mg->runs[r].file = files[r];
+    mg->runs[r].buffer = (stream_job*) malloc(sizeof(stream_job) * per_run);
+    mg->runs[r].capacity = per_run;
+    mg->runs[r].size = 0;
+    mg->runs[r].pos = -1;
+    if (ext_run_advance(&mg->runs[r]))
+      heap_push(&mg->heap, r);
+  }
+}
+
+/**
+   Ends a merge: closes the runs and frees their buffers.
+
+   @return 1 if the runs were read without error, 0 otherwise
+ */
+static int ext_merge_end(ext_merger *mg, int num_runs) {
+  int ok = 1;
+  for (int r = 0; r < num_runs; r++) {
+    ok &= !ferror(mg->runs[r].file);
+    fclose(mg->runs[r].file);
+    free(mg->runs[r].buffer);
+  }
+  return ok;
+}
+
+/**
+   Merges the runs by groups of fan_in into longer runs until at most
+   fan_in are left, so that the last merge has buffers of records /
+   fan_in records. Each group uses fan_in + 1 buffers (the output one
+   included) of records records in total.
+
+   @param runs the address of the array of runs, replaced by the merged ones
+   @param num_runs the number of runs
+   @param records the number of records of the buffers
+   @param fan_in the number of runs merged at once, at least 2
+
+   @return the number of runs left, -1 on error, with all the runs closed
+ */
+int external_merge_passes(FILE ***runs, int num_runs, long records, int fan_in) {
+  long per_run = records / (fan_in + 1) > 0 ? records / (fan_in + 1) : 1;
+  ext_run *merging = (ext_run*) malloc(sizeof(ext_run) * fan_in);
+  ext_merger mg = { merging, { 0, (int*) malloc(sizeof(int) * fan_in), ext_run_less, merging } };
+  stream_job *output = (stream_job*) malloc(sizeof(stream_job) * per_run);
+  int ok = 1;
+
+  while (ok && num_runs > fan_in) {
+    int merged = 0;
+    for (int first = 0; first < num_runs; first += fan_in) {
+      int group = num_runs - first < fan_in ? num_runs - first : fan_in;
+      FILE *run = ok ? ext_run_file() : NULL;
+      ok &= run != NULL;
+      mg.heap.size = 0;
+      ext_merge_start(&mg, *runs + first, group, per_run);
+      long size = 0;
+      stream_job job;
+      while (ok && ext_merge_next(&mg, &job)) {
+        output[size++] = job;
+        if (size == per_run) {
+          ok &= fwrite(output, sizeof(stream_job), size, run) == (size_t) size;
+          size = 0;
+        }
+      }
+      if (ok && size > 0)
+        ok &= fwrite(output, sizeof(stream_job), size, run) == (size_t) size;
+      ok &= ext_merge_end(&mg, group);
+      if (run != NULL) {
+        rewind(run);
+        (*runs)[merged++] = run;
+      }
+    }
+    num_runs = merged;
+  }
+
+  free(merging);
+  free(mg.heap.items);
+  free(output);
+  if (!ok) {
+    for (int r = 0; r < num_runs; r++)
+      fclose((*runs)[r]);
+    free(*runs);
+    return -1;
+  }
+  return num_runs;
+}
+
+/**
+   Schedules a trace that does not fit in memory, with FCFS or SJF. The
+   trace is sorted by runs of memory bytes, the runs are merged by groups
+   until few enough are left to merge them all at once, and the merged
+   jobs go straight through the scheduling engine. The sort and merge
+   buffers take at most memory bytes, or EXT_MIN_RECORDS records if it is
+   less, and the run files have no stdio buffer. Besides memory, only the
+   ready queue of SJF grows with the trace, and the output file has its
+   stdio buffer. The jobs are written to output as they run.
+
+   @param trace the path of the trace file
+   @param output the path of the output file
+   @param sort_by_burst is used to use the FCFS or SJF algorithms.
+   @param memory the number of bytes for the sort buffers
+   @param summary the address where to store the totals of the schedule
+
+   @return 1 on success, 0 if a file could not be read or written
+ */
+int sch_external(const char *trace, const char *output, int sort_by_burst,
+                 long memory, sch_summary *summary) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (external)\n", sort_by_burst ? "SJF" : "FCFS");
+
+  long records = memory / (long) sizeof(stream_job);
+  if (records < EXT_MIN_RECORDS)
+    records = EXT_MIN_RECORDS;
+  // runs merged at once, each with a buffer of EXT_MIN_RECORDS at least
+  long fan_in = records / EXT_MIN_RECORDS - 1;
+  if (fan_in < 2)
+    fan_in = 2;
+  if (fan_in > 1024)
+    fan_in = 1024;
+
+  FILE *in = fopen(trace, "rb");
+  if (in == NULL)
+    return 0;
+  FILE **files;
+  int num_runs = external_sort_runs(in, records, &files);
+  fclose(in);
+  if (num_runs > fan_in)
+    num_runs = external_merge_passes(&files, num_runs, records, fan_in);
+  if (num_runs < 0)
+    return 0;
+
+  FILE *out = fopen(output, "w");
+  if (out == NULL) {
+    for (int r = 0; r < num_runs; r++)
+      fclose(files[r]);
+    free(files);
+    return 0;
+  }
+
+  // Merge: one buffer per run, sharing the same budget.
+  long per_run = num_runs > 0 ? records / num_runs : records;
+  ext_run *runs = (ext_run*) malloc(sizeof(ext_run) * (num_runs > 0 ? num_runs : 1));
+  ext_merger mg = { runs, { 0, (int*) malloc(sizeof(int) * (num_runs > 0 ? num_runs : 1)), ext_run_less, runs } };
+  ext_merge_start(&mg, files, num_runs, per_run);
+
+  job_source src = { ext_merge_next, &mg };
+  job_sink sink = { ext_output_dispatch, out };
+  stream_result res = execute_stream(&src, &sink, sort_by_burst, NULL);
+
+  int ok = ext_merge_end(&mg, num_runs);
+  free(runs);
+  free(files);
+  free(mg.heap.items);
+  ok &= !ferror(out);
+  ok &= fclose(out) == 0;
+
+  summary->num = res.num;
+  summary->wait_total = res.wait_total;
+  summary->wait_average = res.num > 0 ? (double) res.wait_total / res.num : 0.0;
+  summary->makespan = res.cycle;
+  return ok;
+}
+
+/**
+   Allocates an empty arena for sch_solve_jobs. Its buffers grow with the
+   problems solved and are kept, so a long-running caller stops allocating
+   once warm.
+
+   @return the address of the arena, free it with sch_arena_free
+ */
+sch_arena * sch_arena_malloc() {
+  sch_arena *arena = (sch_arena*) malloc(sizeof(sch_arena));
+  arena->capacity = 0;
+  arena->jobs = NULL;
+  arena->free_slots = NULL;
+  arena->heap = NULL;
+  arena->sorted_capacity = 0;
+  arena->sorted = NULL;
+  return arena;
+}
+
+/**
+   Frees an arena and its buffers.
+
+   @param arena the address of the arena
+ */
+void sch_arena_free(sch_arena *arena) {
+  free(arena->jobs);
+  free(arena->free_slots);
+  free(arena->heap);
+  free(arena->sorted);
+  free(arena);
+}
+
+/*
+  Source reading the jobs sorted in an arena.
+*/
+typedef struct {
+  stream_job *jobs;
+  int num;
+  int pos;
+} array_reader;
+
+static int array_next(void *ctx, stream_job *job) {
+  array_reader *rd = (array_reader*) ctx;
+  if (rd->pos == rd->num)
+    return 0;
+  *job = rd->jobs[rd->pos++];
+  return 1;
+}
+
+static void array_dispatch(void *ctx, stream_job *job, long long start) {
+  (void) start;
+  int **order = (int**) ctx;
+  *(*order)++ = job->id;
+}
+
+/**
+   Compute the schedule of jobs given as a flat array, with FCFS or SJF,
+   using the buffers of arena. The results are the same as sch_fcfs and
+   sch_sjf, without building a table or a solution.
+
+   @param arena the buffers to reuse, see sch_arena_malloc
+   @param num the number of jobs
+   @param jobs the ID, ARRIVAL and BURST of each job, one triple after the
+          other, in any order. It is not modified.
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param order the address where to store the IDs of the num jobs in the
+          order they run
+
+   @return the total wait of the jobs
+ */
+long long sch_solve_jobs(sch_arena *arena, int num, const int *jobs,
+                         int sort_by_burst, int *order) {
+  if (num > arena->sorted_capacity) {
+    arena->sorted_capacity = num;
+    arena->sorted = (stream_job*) realloc(arena->sorted, sizeof(stream_job) * num);
+  }
+  for (int i = 0; i < num; i++) {
+    arena->sorted[i].id = jobs[3 * i + ID];
+    arena->sorted[i].arrival = jobs[3 * i + ARRIVAL];
+    arena->sorted[i].burst = jobs[3 * i + BURST];
+  }
+  if (num > 0)
+    qsort(arena->sorted, num, sizeof(stream_job), stream_job_compare);
+
+  array_reader rd = { arena->sorted, num, 0 };
+  job_source src = { array_next, &rd };
+  job_sink sink = { array_dispatch, &order };
+  return execute_stream(&src, &sink, sort_by_burst, arena).wait_total;
+}
+
+/*
+  Sink passing a record of each job to a callback.
+*/
+typedef struct {
+  sch_record_callback record;
+  void *ctx;
+} record_writer;
+
+static void record_dispatch(void *ctx, stream_job *job, long long start) {
+  record_writer *wr = (record_writer*) ctx;
+  sch_dispatch_record record = { job->id, start, start + job->burst, start - job->arrival };
+  wr->record(wr->ctx, &record);
+}
+
+/*
+  Source reading the rows of a table sorted by arrival time.
+*/
+typedef struct {
+  int **table;
+  int num;
+  int pos;
+} table_reader;
+
+static int table_next(void *ctx, stream_job *job) {
+  table_reader *rd = (table_reader*) ctx;
+  if (rd->pos == rd->num)
+    return 0;
+  int *row = rd->table[rd->pos++];
+  job->id = row[TBL_ID];
+  job->arrival = row[TBL_ARRIVAL];
+  job->burst = row[TBL_BURST];
+  return 1;
+}
+
+static void stream_summary(stream_result *res, sch_summary *summary) {
+  summary->num = res->num;
+  summary->wait_total = res->wait_total;
+  summary->wait_average = res->num > 0 ? (double) res->wait_total / res->num : 0.0;
+  summary->makespan = res->cycle;
+}
+
+/**
+   Compute the schedule of a scheduling problem with FCFS or SJF, giving
+   each job to record when it is dispatched instead of building a
+   solution. Only the totals are kept. The table of sch is sorted by
+   arrival time in place.
+
+   @param sch the address of the scheduling problem to solve
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param record the callback called with ctx and the record of each job,
+          in the order the jobs run
+   @param ctx passed to record, for example a writer of sch_writer_open
+   @param summary the address where to store the totals of the schedule
+ */
+void sch_stream(sch_problem *sch, int sort_by_burst, sch_record_callback record,
+                void *ctx, sch_summary *summary) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (stream)\n", sort_by_burst ? "SJF" : "FCFS");
+
+  sch_table_sort(sch->num, sch->table, TBL_ARRIVAL);
+  table_reader rd = { sch->table, sch->num, 0 };
+  job_source src = { table_next, &rd };
+  record_writer wr = { record, ctx };
+  job_sink sink = { record_dispatch, &wr };
+
+  stream_result res = execute_stream(&src, &sink, sort_by_burst, NULL);
+  stream_summary(&res, summary);
+}
+
+/**
+   Same as sch_stream for a packed problem, decoded as the jobs arrive.
+
+   @param pk the address of the packed problem to solve
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param record the callback called with ctx and the record of each job
+   @param ctx passed to record
+   @param summary the address where to store the totals of the schedule
+ */
+void sch_stream_packed(sch_packed_problem *pk, int sort_by_burst,
+                       sch_record_callback record, void *ctx, sch_summary *summary) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (packed stream)\n", sort_by_burst ? "SJF" : "FCFS");
+
+  packed_reader rd = { pk, 0, 0, 0 };
+  job_source src = { packed_next, &rd };
+  record_writer wr = { record, ctx };
+  job_sink sink = { record_dispatch, &wr };
+
+  stream_result res = execute_stream(&src, &sink, sort_by_burst, NULL);
+  stream_summary(&res, summary);
+}
+
+/*
+  Double buffer of a writer. The engine fills buffer[filling]; a full
+  buffer is handed to the thread through pending, under lock.
+*/
+struct sch_writer {
+  FILE *file;
+  int format;
+  int capacity;
+  sch_dispatch_record *buffer[2];
+  int filling;
+  int size;
+  int pending;
+  int pending_size;
+  int closing;
+  int error;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  pthread_t thread;
+};
+
+static void * writer_main(void *arg) {
+  sch_writer *wr = (sch_writer*) arg;
+  pthread_mutex_lock(&wr->lock);
+  while (1) {
+    while (wr->pending < 0 && !wr->closing)
+      pthread_cond_wait(&wr->changed, &wr->lock);
+    if (wr->pending < 0)
+      break;
+    sch_dispatch_record *records = wr->buffer[wr->pending];
+    int size = wr->pending_size;
+    pthread_mutex_unlock(&wr->lock);
+
+    int ok = 1;
+    if (wr->format == WRITER_BINARY) {
+      ok = fwrite(records, sizeof(sch_dispatch_record), size, wr->file) == (size_t) size;
+    } else {
+      for (int i = 0; i < size && ok; i++)
+        ok = fprintf(wr->file, "%d,%lld,%lld,%lld\n", records[i].id,
+                     records[i].start, records[i].finish, records[i].wait) > 0;
+    }
+
+    pthread_mutex_lock(&wr->lock);
+    wr->error |= !ok;
+    wr->pending = -1;
+    pthread_cond_broadcast(&wr->changed);
+  }
+  pthread_mutex_unlock(&wr->lock);
+  return NULL;
+}
+
+/*
+  Hands the filled buffer to the thread, once it is done with the other.
+*/
+static void writer_swap(sch_writer *wr) {
+  pthread_mutex_lock(&wr->lock);
+  while (wr->pending >= 0)
+    pthread_cond_wait(&wr->changed, &wr->lock);
+  wr->pending = wr->filling;
+  wr->pending_size = wr->size;
+  pthread_cond_broadcast(&wr->changed);
+  pthread_mutex_unlock(&wr->lock);
+  wr->filling = 1 - wr->filling;
+  wr->size = 0;
+}
+
+/**
+   Opens a file to write dispatch records to, and starts its thread.
+
+   @param path the path of the file, truncated
+   @param format WRITER_BINARY or WRITER_CSV
+   @param buffer_records the number of records of each of the two buffers
+
+   @return the address of the writer, or NULL if the file cannot be opened
+           or the thread cannot be started
+ */
+sch_writer * sch_writer_open(const char *path, int format, int buffer_records) {
+  FILE *file = fopen(path, format == WRITER_BINARY ? "wb" : "w");
+  if (file == NULL)
+    return NULL;
+  if (format != WRITER_BINARY)
+    fprintf(file, "id,start,finish,wait\n");
+
+  sch_writer *wr = (sch_writer*) malloc(sizeof(sch_writer));
+  wr->file = file;
+  wr->format = format;
+  wr->capacity = buffer_records > 0 ? buffer_records : 1;
+  wr->buffer[0] = (sch_dispatch_record*) malloc(sizeof(sch_dispatch_record) * wr->capacity);
+  wr->buffer[1] = (sch_dispatch_record*) malloc(sizeof(sch_dispatch_record) * wr->capacity);
+  wr->filling = 0;
+  wr->size = 0;
+  wr->pending = -1;
+  wr->pending_size = 0;
+  wr->closing = 0;
+  wr->error = 0;
+  pthread_mutex_init(&wr->lock, NULL);
+  pthread_cond_init(&wr->changed, NULL);
+  if (pthread_create(&wr->thread, NULL, writer_main, wr) != 0) {
+    fclose(file);
+    remove(path);
+    pthread_mutex_destroy(&wr->lock);
+    pthread_cond_destroy(&wr->changed);
+    free(wr->buffer[0]);
+    free(wr->buffer[1]);
+    free(wr);
+    return NULL;
+  }
+  return wr;
+}
+
+/**
+   Adds a record to a writer. Has the type of sch_record_callback.
+
+   @param writer the address of the writer of sch_writer_open
+   @param record the address of the record, copied
+ */
+void sch_writer_record(void *writer, const sch_dispatch_record *record) {
+  sch_writer *wr = (sch_writer*) writer;
+  wr->buffer[wr->filling][wr->size++] = *record;
+  if (wr->size == wr->capacity)
+    writer_swap(wr);
+}
+
+/**
+   Writes the remaining records, stops the thread, closes the file and
+   frees the writer.
+
+   @param wr the address of the writer of sch_writer_open
+
+   @return 1 if all the records were written, 0 on error
+ */
+int sch_writer_close(sch_writer *wr) {
+  if (wr->size > 0)
+    writer_swap(wr);
+  pthread_mutex_lock(&wr->lock);
+  wr->closing = 1;
+  pthread_cond_broadcast(&wr->changed);
+  pthread_mutex_unlock(&wr->lock);
+  pthread_join(wr->thread, NULL);
+
+  int ok = !wr->error && !ferror(wr->file);
+  ok &= fclose(wr->file) == 0;
+  pthread_mutex_destroy(&wr->lock);
+  pthread_cond_destroy(&wr->changed);
+  free(wr->buffer[0]);
+  free(wr->buffer[1]);
+  free(wr);
+  return ok;
+}
+
+/*
+  Simulation of a sampled window: the source reads the table from the
+  start of the warm-up, the sink sums the waits of the jobs arriving in
+  [from, to), and the source stops once they are all dispatched.
+*/
+typedef struct {
+  int **table;
+  int num;
+  int pos;
+  long long from;
+  long long to;
+  long long remaining;
+  long long wait_total;
+} window_sim;
+
+static int window_next(void *ctx, stream_job *job) {
+  window_sim *ws = (window_sim*) ctx;
+  if (ws->remaining == 0 || ws->pos == ws->num)
+    return 0;
+  int *row = ws->table[ws->pos++];
+  job->id = row[TBL_ID];
+  job->arrival = row[TBL_ARRIVAL];
+  job->burst = row[TBL_BURST];
+  return 1;
+}
+
+static void window_dispatch(void *ctx, stream_job *job, long long start) {
+  window_sim *ws = (window_sim*) ctx;
+  if (job->arrival >= ws->from && job->arrival < ws->to) {
+    ws->remaining--;
+    ws->wait_total += start - job->arrival;
+  }
+}
+
+/*
+  Index of the first row of a table sorted by arrival time arriving at or
+  after arrival.
+*/
+static int lower_arrival(int **table, int num, long long arrival) {
+  int lo = 0, hi = num;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (table[mid][TBL_ARRIVAL] < arrival)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/*
+  Quantile of the standard normal distribution, p in [0.5, 1).
+*/
+static double normal_quantile(double p) {
+  double lo = 0.0, hi = 40.0;
+  for (int i = 0; i < 100; i++) {
+    double mid = (lo + hi) / 2;
+    if (0.5 * erfc(-mid / sqrt(2.0)) < p)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+   Estimates the average wait of FCFS or SJF by simulating a stratified
+   sample of time windows, see sch_sample_config. In each stratum the
+   total wait is estimated from the totals of its sampled windows, with
+   the variance of sampling without replacement.
+
+   @param sch the address of the scheduling problem, its table must be
+          sorted by arrival time then ID (as left by sch_pack or sch_stream)
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param config the address of the sampling parameters
+   @param report the address where to store the estimate
+
+   @return 1, or 0 if the parameters are not valid, a single sample of
+           several windows included
+ */
+int sch_sample(sch_problem *sch, int sort_by_burst, sch_sample_config *config,
+               sch_sample_report *report) {
+  if (config->strata < 1 || config->windows < 1 || config->samples < 1 ||
+      (config->samples < 2 && config->windows >= 2) || config->warmup < 0 || config->confidence <= 0.0 || config->confidence >= 1.0)
+    return 0;
+  if(SCH_VERBOSE)
+    printf("*********** %s (sampled)\n", sort_by_burst ? "SJF" : "FCFS");
+
+  report->wait_average = 0.0;
+  report->std_error = 0.0;
+  report->ci_low = 0.0;
+  report->ci_high = 0.0;
+  report->jobs_sampled = 0;
+  report->jobs_simulated = 0;
+  if (sch->num == 0)
+    return 1;
+
+  long long first = sch->table[0][TBL_ARRIVAL];
+  long long span = (long long) sch->table[sch->num - 1][TBL_ARRIVAL] + 1 - first;
+  long long count = (long long) config->strata * config->windows;
+  int samples = config->samples < config->windows ? config->samples : config->windows;
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ config->seed;
+  int *pick = (int*) malloc(sizeof(int) * config->windows);
+  double *totals = (double*) malloc(sizeof(double) * samples);
+  double total = 0.0, variance = 0.0;
+
+  for (int h = 0; h < config->strata; h++) {
+    for (int w = 0; w < config->windows; w++)
+      pick[w] = w;
+    double mean = 0.0;
+    for (int k = 0; k < samples; k++) {
+      // partial Fisher-Yates: the first samples windows are a random subset
+      int j = k + (int) (rng_next(&state) % (config->windows - k));
+      int swap = pick[k];
+      pick[k] = pick[j];
+      pick[j] = swap;
+
+      long long w = (long long) h * config->windows + pick[k];
+      window_sim ws;
+      ws.table = sch->table;
+      ws.num = sch->num;
+      ws.from = first + span * w / count;
+      ws.to = first + span * (w + 1) / count;
+      ws.pos = lower_arrival(sch->table, sch->num, ws.from - config->warmup);
+      ws.remaining = lower_arrival(sch->table, sch->num, ws.to) -
+                     lower_arrival(sch->table, sch->num, ws.from);
+      ws.wait_total = 0;
+      report->jobs_sampled += ws.remaining;
+      if (ws.remaining > 0) {
+        job_source src = { window_next, &ws };
+        job_sink sink = { window_dispatch, &ws };
+        report->jobs_simulated += execute_stream(&src, &sink, sort_by_burst, NULL).num;
+      }
+      totals[k] = (double) ws.wait_total;
+      mean += totals[k];
+    }
+    mean /= samples;
+
+    double s2 = 0.0;
+    for (int k = 0; k < samples; k++)
+      s2 += (totals[k] - mean) * (totals[k] - mean);
+    s2 = samples > 1 ? s2 / (samples - 1) : 0.0;
+    total += mean * config->windows;
+    variance += (double) config->windows * config->windows *
+                (1.0 - (double) samples / config->windows) * s2 / samples;
+  }
+
+  double z = normal_quantile((1.0 + config->confidence) / 2);
+  report->wait_average = total / sch->num;
+  report->std_error = sqrt(variance) / sch->num;
+  report->ci_low = report->wait_average - z * report->std_error;
+  report->ci_high = report->wait_average + z * report->std_error;
+
+  free(pick);
+  free(totals);
+  return 1;
+}
+
+#define CHECKPOINT_MAGIC   0x4B484353
+#define CHECKPOINT_VERSION 1
+
+/*
+  The ready jobs are kept like in execute_stream: in slots recycled
+  through a stack of free slots, ordered by a heap of slots.
+*/
+struct sch_engine {
+  int sort_by_burst;
+  long long cycle;
+  long long next;
+  long long dispatched;
+  long long wait_total;
+  int capacity;
+  stream_job *jobs;
+  int *free_slots;
+  int free_size;
+  sch_heap ready;
+};
+
+static sch_engine * engine_malloc(int sort_by_burst, int capacity) {
+  sch_engine *eng = (sch_engine*) malloc(sizeof(sch_engine));
+  eng->sort_by_burst = sort_by_burst;
+  eng->cycle = 0;
+  eng->next = 0;
+  eng->dispatched = 0;
+  eng->wait_total = 0;
+  eng->capacity = capacity > 16 ? capacity : 16;
+  eng->jobs = (stream_job*) malloc(sizeof(stream_job) * eng->capacity);
+  eng->free_slots = (int*) malloc(sizeof(int) * eng->capacity);
+  eng->free_size = 0;
+  eng->ready.size = 0;
+  eng->ready.items = (int*) malloc(sizeof(int) * eng->capacity);
+  eng->ready.less = stream_sjf_less;
+  eng->ready.ctx = eng->jobs;
+  return eng;
+}
+
+/**
+   Allocates the state of a schedule that has not started.
+
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+
+   @return the address of the state, free it with sch_engine_free
+ */
+sch_engine * sch_engine_malloc(int sort_by_burst) {
+  return engine_malloc(sort_by_burst, 0);
+}
+
+/**
+   Frees the state of a schedule.
+
+   @param eng the address of the state
+ */
+void sch_engine_free(sch_engine *eng) {
+  free(eng->jobs);
+  free(eng->free_slots);
+  free(eng->ready.items);
+  free(eng);
+}
+
+/**
+   Copies the state of a schedule, to run a what-if from the same point.
+   The ready jobs of the copy are packed in its first slots.
+
+   @param eng the address of the state to copy
+
+   @return the address of the copy, free it with sch_engine_free
+ */
+sch_engine * sch_engine_copy(sch_engine *eng) {
+  sch_engine *copy = engine_malloc(eng->sort_by_burst, eng->ready.size);
+  copy->cycle = eng->cycle;
+  copy->next = eng->next;
+  copy->dispatched = eng->dispatched;
+  copy->wait_total = eng->wait_total;
+  // the slots in heap order are a heap over the slots 0, 1, ...
+  for (int k = 0; k < eng->ready.size; k++) {
+    copy->jobs[k] = eng->jobs[eng->ready.items[k]];
+    copy->ready.items[k] = k;
+  }
+  copy->ready.size = eng->ready.size;
+  return copy;
+}
+
+/**
+   Runs a schedule until all the jobs are dispatched, or until the next
+   job would start at cycle until or later. The results are the same as
+   sch_fcfs and sch_sjf, the state can be run again with a later until.
+
+   @param eng the address of the state of the schedule
+   @param sch the address of the scheduling problem, its table must be
+          sorted by arrival time then ID (as left by sch_pack or sch_stream)
+   @param until the cycle to stop at, or -1 to run to the end
+   @param record the callback called with ctx and the record of each job
+          dispatched, or NULL
+   @param ctx passed to record
+
+   @return 1 if jobs remain, 0 if the schedule is finished
+ */
+int sch_engine_run(sch_engine *eng, sch_problem *sch, long long until,
+                   sch_record_callback record, void *ctx) {
+  while (1) {
+    long long start = eng->cycle;
+    stream_job job;
+    if (eng->ready.size == 0) {
+      if (eng->next >= sch->num)
+        return 0;
+      if (start < sch->table[eng->next][TBL_ARRIVAL])
+        start = sch->table[eng->next][TBL_ARRIVAL];
+    }
+    if (until >= 0 && start >= until)
+      return 1;
+
+    if (!eng->sort_by_burst) {
+      int *row = sch->table[eng->next++];
+      job.id = row[TBL_ID];
+      job.arrival = row[TBL_ARRIVAL];
+      job.burst = row[TBL_BURST];
+    } else {
+      while (eng->next < sch->num && sch->table[eng->next][TBL_ARRIVAL] <= start) {
+        int *row = sch->table[eng->next++];
+        int slot;
+        if (eng->free_size > 0) {
+          slot = eng->free_slots[--eng->free_size];
+        } else {
+          if (eng->ready.size == eng->capacity) {
+            eng->capacity *= 2;
+            eng->jobs = (stream_job*) realloc(eng->jobs, sizeof(stream_job) * eng->capacity);
+            eng->free_slots = (int*) realloc(eng->free_slots, sizeof(int) * eng->capacity);
+            eng->ready.items = (int*) realloc(eng->ready.items, sizeof(int) * eng->capacity);
+            eng->ready.ctx = eng->jobs;
+          }
+          slot = eng->ready.size;
+        }
+        eng->jobs[slot].id = row[TBL_ID];
+        eng->jobs[slot].arrival = row[TBL_ARRIVAL];
+        eng->jobs[slot].burst = row[TBL_BURST];
+        heap_push(&eng->ready, slot);
+      }
+      int slot = heap_pop(&eng->ready);
+      eng->free_slots[eng->free_size++] = slot;
+      job = eng->jobs[slot];
+    }
+
+    if (record != NULL) {
+      sch_dispatch_record rec = { job.id, start, start + job.burst, start - job.arrival };
+      record(ctx, &rec);
+    }
+    eng->wait_total += start - job.arrival;
+    eng->cycle = start + job.burst;
+    eng->dispatched++;
+  }
+}
+
+/**
+   Gives the totals of the jobs dispatched so far.
+
+   @param eng the address of the state of the schedule
+   @param summary the address where to store the totals; makespan is the
+          cycle at which the last dispatched job finishes
+ */
+void sch_engine_summary(sch_engine *eng, sch_summary *summary) {
+  summary->num = eng->dispatched;
+  summary->wait_total = eng->wait_total;
+  summary->wait_average = eng->dispatched > 0 ? (double) eng->wait_total / eng->dispatched : 0.0;
+  summary->makespan = eng->cycle;
+}
+
+/**
+   Saves the state of a schedule to a checkpoint file, see sch_engine.
+
+   @param eng the address of the state of the schedule
+   @param path the path of the checkpoint file, truncated
+
+   @return 1 on success, 0 on error
+ */
+int sch_engine_save(sch_engine *eng, const char *path) {
+  FILE *out = fopen(path, "wb");
+  if (out == NULL)
+    return 0;
+  int header[4] = { CHECKPOINT_MAGIC, CHECKPOINT_VERSION, eng->sort_by_burst, eng->ready.size };
+  long long counters[4] = { eng->cycle, eng->next, eng->dispatched, eng->wait_total };
+  int ok = fwrite(header, sizeof(int), 4, out) == 4;
+  ok &= fwrite(counters, sizeof(long long), 4, out) == 4;
+  // in heap order, so that loading needs no sort
+  for (int k = 0; ok && k < eng->ready.size; k++) {
+    stream_job *job = &eng->jobs[eng->ready.items[k]];
+    int triple[3] = { job->id, job->arrival, job->burst };
+    ok = fwrite(triple, sizeof(int), 3, out) == 3;
+  }
+  ok &= fclose(out) == 0;
+  return ok;
+}
+
+/**
+   Loads the state of a schedule from a checkpoint file of sch_engine_save.
+
+   @param path the path of the checkpoint file
+
+   @return the address of the state, or NULL if the file cannot be read
+           or is not a checkpoint, FCFS with ready jobs included. Free it
+           with sch_engine_free.
+ */
+sch_engine * sch_engine_load(const char *path) {
+  FILE *in = fopen(path, "rb");
+  if (in == NULL)
+    return NULL;
+  int header[4];
+  long long counters[4];
+  if (fread(header, sizeof(int), 4, in) != 4 || header[0] != CHECKPOINT_MAGIC ||
+      header[1] != CHECKPOINT_VERSION || (header[2] != 0 && header[2] != 1) ||
+      header[3] < 0 || (header[2] == 0 && header[3] != 0) ||
+      fread(counters, sizeof(long long), 4, in) != 4 ||
+      counters[1] < 0 || counters[2] < 0) {
+    fclose(in);
+    return NULL;
+  }
+
+  sch_engine *eng = engine_malloc(header[2], header[3]);
+  eng->cycle = counters[0];
+  eng->next = counters[1];
+  eng->dispatched = counters[2];
+  eng->wait_total = counters[3];
+  int ok = 1;
+  for (int k = 0; ok && k < header[3]; k++) {
+    int triple[3];
+    ok = fread(triple, sizeof(int), 3, in) == 3;
+    eng->jobs[k].id = triple[0];
+    eng->jobs[k].arrival = triple[1];
+    eng->jobs[k].burst = triple[2];
+    eng->ready.items[k] = k;
+  }
+  eng->ready.size = header[3];
+  fclose(in);
+  if (!ok) {
+    sch_engine_free(eng);
+    return NULL;
+  }
+  return eng;
+}
+
+/**
+   Computes the estimate of the next burst of every process from its
+   history, by exponential averaging. The estimate after the bursts
+   b[0] .. b[n-1] is the sum of (1 - alpha)^n * initial and of
+   alpha * (1 - alpha)^(n-1-j) * b[j], so the weights are computed once
+   for the longest history and each process is a dot product over its
+   contiguous bursts, summed in 4 independent partial sums so that the
+   compiler can keep them in one vector register without -ffast-math.
+
+   @param history the address of the histories
+   @param alpha the weight of the last burst, in [0, 1]
+   @param initial the estimate before any burst
+   @param estimate the address where to store history->processes estimates
+ */
+void sch_history_estimates(sch_history *history, float alpha, float initial,
+                           float *estimate) {
+  int longest = 0;
+  for (int p = 0; p < history->processes; p++) {
+    int n = history->first[p + 1] - history->first[p];
+    if (n > longest)
+      longest = n;
+  }
+
+  // weight[longest - 1 - k] is alpha * (1 - alpha)^k, decay[n] is (1 - alpha)^n
+  float *weight = (float*) malloc(sizeof(float) * (longest + 1));
+  float *decay = (float*) malloc(sizeof(float) * (longest + 1));
+  decay[0] = 1.0f;
+  for (int k = 0; k < longest; k++) {
+    weight[longest - 1 - k] = alpha * decay[k];
+    decay[k + 1] = decay[k] * (1.0f - alpha);
+  }
+
+  for (int p = 0; p < history->processes; p++) {
+    int n = history->first[p + 1] - history->first[p];
+    const int *burst = &history->burst[history->first[p]];
+    const float *w = &weight[longest - n];
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+      sum[0] += w[j] * burst[j];
+      sum[1] += w[j + 1] * burst[j + 1];
+      sum[2] += w[j + 2] * burst[j + 2];
+      sum[3] += w[j + 3] * burst[j + 3];
+    }
+    for (; j < n; j++)
+      sum[0] += w[j] * burst[j];
+    estimate[p] = (sum[0] + sum[1]) + (sum[2] + sum[3]) + decay[n] * initial;
+  }
+
+  free(weight);
+  free(decay);
+}
+
+/*
+  Ready jobs of the predicted SJF, by predicted remaining time then ID.
+*/
+typedef struct {
+  int **table;
+  double *left;
+} predicted_ctx;
+
+static int predicted_less(int a, int b, void *ctx) {
+  predicted_ctx *pc = (predicted_ctx*) ctx;
+  if (pc->left[a] != pc->left[b])
+    return pc->left[a] < pc->left[b];
+  return pc->table[a][TBL_ID] < pc->table[b][TBL_ID];
+}
+
+/**
+   Executes the schedule with SJF or SRTF on predicted bursts, from event
+   to event like execute_edf. A job gets the estimate of its process when
+   it arrives; pre-emptive, the running job only runs until the next
+   arrival and its predicted remaining time goes down as it runs, never
+   below 0. The order of completion and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param estimate is the estimate of each process, updated as jobs finish
+   @param config is the alpha of the updates and whether to pre-empt
+   @param oracle is used to predict the real burst, as sch_sjf does
+   @param error is where to store the sums of |prediction - burst| and of
+          prediction - burst, or NULL
+ */
+void execute_predicted(sch_problem *sch, sch_solution *sol, float *estimate,
+                       sch_predict_config *config, int oracle, double *error) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+
+  int *remaining = (int*) malloc(sizeof(int) * sch->num);
+  double *left = (double*) malloc(sizeof(double) * sch->num);
+  predicted_ctx pc = { sch->table, left };
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * sch->num), predicted_less, &pc };
+  if (error != NULL) {
+    error[0] = 0.0;
+    error[1] = 0.0;
+  }
+
+  int job_id = 0, order_id = 0;
+  long long cycle = 0, wait_time = 0;
+  while(order_id < sch->num) {
+    while((job_id < sch->num) && (sch->table[job_id][TBL_ARRIVAL] <= cycle)) {
+      int *job = sch->table[job_id];
+      remaining[job_id] = job[TBL_BURST];
+      left[job_id] = oracle ? job[TBL_BURST] : estimate[job[TBL_PROCESS]];
+      if (error != NULL) {
+        error[0] += fabs(left[job_id] - job[TBL_BURST]);
+        error[1] += left[job_id] - job[TBL_BURST];
+      }
+      heap_push(&ready,job_id);
+      job_id++;
+    }
+
+    if (ready.size == 0) {
+      cycle = sch->table[job_id][TBL_ARRIVAL];
+      continue;
+    }
+
+    int next = heap_pop(&ready);
+    int *job = sch->table[next];
+    long long slice = remaining[next];
+    if (config->preemptive && job_id < sch->num && sch->table[job_id][TBL_ARRIVAL] - cycle < slice) {
+      slice = sch->table[job_id][TBL_ARRIVAL] - cycle;
+    }
+    if (SCH_VERBOSE && slice > 0) {
+      printf("(  %lld) Running job %d for %lld, predicted remaining %.2f.\n",
+        cycle, job[TBL_ID], slice, left[next]);
+    }
+    cycle += slice;
+    remaining[next] -= slice;
+    left[next] = left[next] > slice ? left[next] - slice : 0.0;
+
+    if (remaining[next] > 0) {
+      heap_push(&ready,next);
+      continue;
+    }
+
+    if (!oracle) {
+      float *e = &estimate[job[TBL_PROCESS]];
+      *e = config->alpha * job[TBL_BURST] + (1.0f - config->alpha) * *e;
+    }
+    wait_time += cycle - job[TBL_ARRIVAL] - job[TBL_BURST];
+    sol->order[order_id] = job[TBL_ID];
+    order_id++;
+  }
+
+  free(remaining);
+  free(left);
+  free(ready.items);
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+}
+
+/**
+   Compute the solution to a scheduling problem with SJF or SRTF on bursts
+   predicted from the history of the process of each job, see
+   sch_predict_config. The order is the order of completion.
+
+   @param sch the address of the scheduling problem to solve; the PROCESS
+          of each job must be in [0, processes)
+   @param processes the number of processes
+   @param history the address of the past bursts of the processes, or NULL
+          to start every process at config->initial
+   @param config the address of the parameters of the prediction
+   @param report the address where to store the quality of the
+          predictions against SJF (or SRTF) knowing the bursts, or NULL
+
+   @return the address of the computer scheduling solution, or NULL if a
+           PROCESS is out of [0, processes) or history has more processes
+ */
+sch_solution * sch_sjf_predicted(sch_problem *sch, int processes, sch_history *history,
+                                 sch_predict_config *config, sch_predict_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (predicted)\n", config->preemptive ? "SRTF" : "SJF");
+  info_table("sch_sjf_predicted",sch->num,sch->table);
+  if (history != NULL && history->processes > processes)
+    return NULL;
+  for (int i = 0; i < sch->num; i++)
+    if (sch->table[i][TBL_PROCESS] < 0 || sch->table[i][TBL_PROCESS] >= processes)
+      return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  float *estimate = (float*) malloc(sizeof(float) * (processes > 0 ? processes : 1));
+  for (int p = 0; p < processes; p++)
+    estimate[p] = config->initial;
+  if (history != NULL)
+    sch_history_estimates(history, config->alpha, config->initial, estimate);
+
+  double error[2];
+  execute_predicted(sch,sol,estimate,config,0,error);
+
+  if (report != NULL) {
+    sch_solution oracle;
+    oracle.num = sch->num;
+    sch_solution_malloc(&oracle);
+    execute_predicted(sch,&oracle,NULL,config,1,NULL);
+    report->wait_average = sol->wait_average;
+    report->oracle_wait_average = oracle.wait_average;
+    report->wait_penalty = sol->wait_average - oracle.wait_average;
+    report->prediction_error = sch->num > 0 ? error[0] / sch->num : 0.0;
+    report->prediction_bias = sch->num > 0 ? error[1] / sch->num : 0.0;
+    free(oracle.order);
+  }
+
+  free(estimate);
+  return sol;
+}
+
+/*
+  Buffers of one MLFQ run: the remaining burst of each job, one queue of
+  capacity num per level (a ring), and the response times.
+*/
+typedef struct {
+  int num;
+  int levels;
+  int *remaining;
+  int *queue;
+  int *head;
+  int *size;
+  long long *response;
+} mlfq_scratch;
+
+static void mlfq_scratch_malloc(mlfq_scratch *scr, int num, int levels) {
+  scr->num = num;
+  scr->levels = levels;
+  scr->remaining = (int*) malloc(sizeof(int) * (num > 0 ? num : 1));
+  scr->queue = (int*) malloc(sizeof(int) * (size_t) levels * (num > 0 ? num : 1));
+  scr->head = (int*) malloc(sizeof(int) * levels);
+  scr->size = (int*) malloc(sizeof(int) * levels);
+  scr->response = (long long*) malloc(sizeof(long long) * (num > 0 ? num : 1));
+}
+
+static void mlfq_scratch_free(mlfq_scratch *scr) {
+  free(scr->remaining);
+  free(scr->queue);
+  free(scr->head);
+  free(scr->size);
+  free(scr->response);
+}
+
+static void mlfq_enqueue(mlfq_scratch *scr, int level, int job) {
+  scr->queue[(size_t) level * scr->num + (scr->head[level] + scr->size[level]) % scr->num] = job;
+  scr->size[level]++;
+}
+
+/*
+  Limits of a run of run_mlfq: it stops as soon as the total wait of the
+  finished jobs exceeds wait_bound, or as soon as over_limit jobs have a
+  response time above response_bound.
+*/
+typedef struct {
+  long long wait_bound;
+  long long response_bound;
+  int over_limit;
+} mlfq_bounds;
+
+/**
+   Runs MLFQ (see sch_mlfq) over jobs sorted by arrival time then ID.
+
+   @param jobs the jobs to schedule
+   @param scr the buffers of the run, for num jobs and levels levels
+   @param quantum the number of cycles of a turn in level 0
+   @param bounds the limits to stop at, or NULL to run to the end
+   @param order where to store the IDs in the order of completion, or NULL
+          not to store them nor print the turns
+   @param wait_total where to store the total wait
+
+   @return 1 if the run finished, 0 if it was stopped by bounds
+ */
+static int run_mlfq(stream_job *jobs, mlfq_scratch *scr, int quantum,
+                    mlfq_bounds *bounds, int *order, long long *wait_total) {
+  int num = scr->num, levels = scr->levels;
+  if (quantum < 1)
+    quantum = 1;
+  for (int l = 0; l < levels; l++) {
+    scr->head[l] = 0;
+    scr->size[l] = 0;
+  }
+
+  int job_id = 0, order_id = 0, over = 0;
+  long long cycle = 0, wait_time = 0;
+  while (order_id < num) {
+    while (job_id < num && jobs[job_id].arrival <= cycle) {
+      scr->remaining[job_id] = jobs[job_id].burst;
+      scr->response[job_id] = -1;
+      mlfq_enqueue(scr, 0, job_id);
+      job_id++;
+    }
+
+    int level = 0;
+    while (level < levels && scr->size[level] == 0)
+      level++;
+    if (level == levels) {
+      cycle = jobs[job_id].arrival;
+      continue;
+    }
+
+    int next = scr->queue[(size_t) level * num + scr->head[level]];
+    scr->head[level] = (scr->head[level] + 1) % num;
+    scr->size[level]--;
+    stream_job *job = &jobs[next];
+    if (scr->response[next] < 0) {
+      scr->response[next] = cycle - job->arrival;
+      if (bounds != NULL && scr->response[next] > bounds->response_bound &&
+          ++over >= bounds->over_limit)
+        return 0;
+    }
+
+    long long turn = level < 31 ? (long long) quantum << level : (long long) quantum << 31;
+    long long slice = scr->remaining[next] < turn ? scr->remaining[next] : turn;
+    if (SCH_VERBOSE && order != NULL && slice > 0) {
+      printf("(  %lld) Running job %d for %lld, level %d.\n", cycle, job->id, slice, level);
+    }
+    cycle += slice;
+    scr->remaining[next] -= slice;
+
+    // The jobs arriving during the turn are queued first.
+    while (job_id < num && jobs[job_id].arrival <= cycle) {
+      scr->remaining[job_id] = jobs[job_id].burst;
+      scr->response[job_id] = -1;
+      mlfq_enqueue(scr, 0, job_id);
+      job_id++;
+    }
+    if (scr->remaining[next] > 0) {
+      mlfq_enqueue(scr, level + 1 < levels ? level + 1 : level, next);
+      continue;
+    }
+
+    wait_time += cycle - job->arrival - job->burst;
+    if (order != NULL)
+      order[order_id] = job->id;
+    order_id++;
+    if (bounds != NULL && wait_time > bounds->wait_bound)
+      return 0;
+  }
+
+  *wait_total = wait_time;
+  return 1;
+}
+
+/**
+   Copies the jobs of a table to an array sorted by arrival time then ID.
+
+   @return the array, to free
+ */
+static stream_job * sorted_jobs(sch_problem *sch) {
+  stream_job *jobs = (stream_job*) malloc(sizeof(stream_job) * (sch->num > 0 ? sch->num : 1));
+  for (int i = 0; i < sch->num; i++) {
+    jobs[i].id = sch->table[i][TBL_ID];
+    jobs[i].arrival = sch->table[i][TBL_ARRIVAL];
+    jobs[i].burst = sch->table[i][TBL_BURST];
+  }
+  if (sch->num > 0)
+    qsort(jobs, sch->num, sizeof(stream_job), stream_job_compare);
+  return jobs;
+}
+
+/**
+   Executes the schedule with MLFQ, see sch_mlfq. The order of completion
+   and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param levels is the number of levels, 1 for RR
+   @param quantum is the number of cycles of a turn in level 0
+ */
+void execute_mlfq(sch_problem *sch, sch_solution *sol, int levels, int quantum) {
+  if (levels < 1)
+    levels = 1;
+  stream_job *jobs = sorted_jobs(sch);
+  mlfq_scratch scr;
+  mlfq_scratch_malloc(&scr, sch->num, levels);
+
+  long long wait_time = 0;
+  run_mlfq(jobs, &scr, quantum, NULL, sol->order, &wait_time);
+
+  mlfq_scratch_free(&scr);
+  free(jobs);
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+}
+
+static int long_long_compare(const void *a, const void *b) {
+  long long x = *(const long long*) a, y = *(const long long*) b;
+  return x < y ? -1 : x > y;
+}
+
+/*
+  State shared by the threads of sch_tune_quantum. The best score so far
+  is read without the lock to prune; the best score and quantum are
+  updated together under the lock.
+*/
+typedef struct {
+  stream_job *jobs;
+  int num;
+  sch_tune_config *config;
+  int candidates;
+  atomic_int next;
+  atomic_llong bound;
+  pthread_mutex_t lock;
+  long long best;
+  int best_quantum;
+  int evaluated;
+  int pruned;
+} tune_state;
+
+static void * tune_worker(void *arg) {
+  tune_state *ts = (tune_state*) arg;
+  mlfq_scratch scr;
+  mlfq_scratch_malloc(&scr, ts->num, ts->config->levels);
+  // the 99th percentile is the response of rank p99 among the sorted ones
+  int p99 = (int) ((ts->num - 1) * 99LL / 100);
+
+  int c;
+  while ((c = atomic_fetch_add(&ts->next, 1)) < ts->candidates) {
+    int quantum = ts->config->min_quantum + c * ts->config->step;
+    long long bound = atomic_load_explicit(&ts->bound, memory_order_relaxed);
+    mlfq_bounds bounds = { LLONG_MAX, LLONG_MAX, ts->num + 1 };
+    if (ts->config->objective == TUNE_WAIT) {
+      bounds.wait_bound = bound;
+    } else {
+      bounds.response_bound = bound;
+      bounds.over_limit = ts->num - p99;
+    }
+
+    long long wait_total, score = 0;
+    int finished = run_mlfq(ts->jobs, &scr, quantum, &bounds, NULL, &wait_total);
+    if (finished) {
+      if (ts->config->objective == TUNE_WAIT) {
+        score = wait_total;
+      } else {
+        qsort(scr.response, ts->num, sizeof(long long), long_long_compare);
+        score = ts->num > 0 ? scr.response[p99] : 0;
+      }
+    }
+
+    pthread_mutex_lock(&ts->lock);
+    if (finished) {
+      ts->evaluated++;
+      if (score < ts->best || (score == ts->best && quantum < ts->best_quantum)) {
+        ts->best = score;
+        ts->best_quantum = quantum;
+        atomic_store_explicit(&ts->bound, score, memory_order_relaxed);
+      }
+    } else {
+      ts->pruned++;
+    }
+    pthread_mutex_unlock(&ts->lock);
+  }
+
+  mlfq_scratch_free(&scr);
+  return NULL;
+}
+
+/**
+   Searches the best quantum of RR or MLFQ, see sch_tune_config. The
+   candidates are shared by the threads, which all read one copy of the
+   jobs sorted by arrival time and each have their own buffers. A run
+   stops as soon as it cannot beat the best finished one: when the waits
+   of its finished jobs exceed the best total wait, or when more than 1%
+   of its jobs have waited longer than the best 99th percentile for their
+   first run. The result does not depend on the number of threads.
+
+   @param sch the address of the scheduling problem, not modified
+   @param config the address of the search parameters
+   @param report the address where to store the best quantum
+
+   @return 1, or 0 if the parameters are not valid
+ */
+int sch_tune_quantum(sch_problem *sch, sch_tune_config *config, sch_tune_report *report) {
+  if (config->levels < 1 || config->min_quantum < 1 || config->step < 1 ||
+      config->max_quantum < config->min_quantum ||
+      (config->objective != TUNE_WAIT && config->objective != TUNE_P99_RESPONSE))
+    return 0;
+
+  tune_state ts;
+  ts.jobs = sorted_jobs(sch);
+  ts.num = sch->num;
+  ts.config = config;
+  ts.candidates = (config->max_quantum - config->min_quantum) / config->step + 1;
+  atomic_init(&ts.next, 0);
+  atomic_init(&ts.bound, LLONG_MAX);
+  pthread_mutex_init(&ts.lock, NULL);
+  ts.best = LLONG_MAX;
+  ts.best_quantum = 0;
+  ts.evaluated = 0;
+  ts.pruned = 0;
+
+  int threads = config->threads > 1 ? config->threads : 1;
+  if (threads > ts.candidates)
+    threads = ts.candidates;
+  pthread_t *pool = (pthread_t*) malloc(sizeof(pthread_t) * threads);
+  // the candidates are shared: with fewer threads, the ones started do
+  // all the work
+  int created = 1;
+  while (created < threads &&
+         pthread_create(&pool[created], NULL, tune_worker, &ts) == 0)
+    created++;
+  tune_worker(&ts);
+  for (int t = 1; t < created; t++)
+    pthread_join(pool[t], NULL);
+
+  report->quantum = ts.best_quantum;
+  report->score = config->objective == TUNE_WAIT && sch->num > 0 ?
+                  (double) ts.best / sch->num : (double) ts.best;
+  report->evaluated = ts.evaluated;
+  report->pruned = ts.pruned;
+
+  pthread_mutex_destroy(&ts.lock);
+  free(pool);
+  free(ts.jobs);
+  return 1;
+}
+
+#define BATCH_MAX_LANES 16
+
+/**
+   Allocates a batch of small problems. The arrays are left for the
+   caller to fill, except first[0].
+
+   @param count the number of problems
+   @param jobs the total number of jobs of all the problems
+
+   @return the address of the batch
+ */
+sch_batch_problem * sch_batch_problem_malloc(int count, int jobs) {
+  sch_batch_problem *batch = (sch_batch_problem*) malloc(sizeof(sch_batch_problem));
+  batch->count = count;
+  batch->jobs = jobs;
+  batch->first = (int*) malloc(sizeof(int) * (count + 1));
+  batch->id = (int*) malloc(sizeof(int) * (jobs > 0 ? jobs : 1));
+  batch->arrival = (int*) malloc(sizeof(int) * (jobs > 0 ? jobs : 1));
+  batch->burst = (int*) malloc(sizeof(int) * (jobs > 0 ? jobs : 1));
+  batch->first[0] = 0;
+  return batch;
+}
+
+/**
+   Frees a batch of small problems.
+
+   @param batch the address of the batch
+ */
+void sch_batch_problem_free(sch_batch_problem *batch) {
+  free(batch->first);
+  free(batch->id);
+  free(batch->arrival);
+  free(batch->burst);
+  free(batch);
+}
+
+/**
+   Copies scheduling problems to a batch. The tables are not modified.
+
+   @param problems the addresses of the count problems
+   @param count the number of problems
+
+   @return the address of the batch
+ */
+sch_batch_problem * sch_batch_pack(sch_problem **problems, int count) {
+  int jobs = 0;
+  for (int p = 0; p < count; p++)
+    jobs += problems[p]->num;
+  sch_batch_problem *batch = sch_batch_problem_malloc(count, jobs);
+  int j = 0;
+  for (int p = 0; p < count; p++) {
+    for (int i = 0; i < problems[p]->num; i++, j++) {
+      batch->id[j] = problems[p]->table[i][TBL_ID];
+      batch->arrival[j] = problems[p]->table[i][TBL_ARRIVAL];
+      batch->burst[j] = problems[p]->table[i][TBL_BURST];
+    }
+    batch->first[p + 1] = j;
+  }
+  return batch;
+}
+
+/*
+  Job of a small problem while it is sorted: ARRIVAL in the high half of
+  the key, ID with its sign bit flipped (to order it as unsigned) in the
+  low half.
+*/
+typedef struct {
+  long long key;
+  int burst;
+} batch_job;
+
+/*
+  Sorts the jobs of a small problem by arrival time then ID, insertion
+  sort up to 32 jobs. Input sorted already costs one pass.
+*/
+static int batch_job_compare(const void *a, const void *b) {
+  long long x = ((const batch_job*) a)->key, y = ((const batch_job*) b)->key;
+  return x < y ? -1 : x > y;
+}
+
+static void batch_sort(batch_job *jobs, int num) {
+  if (num > 32) {
+    qsort(jobs, num, sizeof(batch_job), batch_job_compare);
+    return;
+  }
+  for (int i = 1; i < num; i++) {
+    batch_job job = jobs[i];
+    int j = i - 1;
+    while (j >= 0 && jobs[j].key > job.key) {
+      jobs[j + 1] = jobs[j];
+      j--;
+    }
+    jobs[j + 1] = job;
+  }
+}
+
+/*
+  The lane kernels run steps FCFS steps on lanes problems whose sorted
+  jobs are interleaved: job k of lane l at arrival[k * lanes + l]. The
+  padding after the last job of a lane arrives at INT_MAX with burst 0,
+  so it adds no wait. All the finish times must fit in an int. The AVX2
+  and AVX-512 kernels are called with 8 and 16 lanes.
+*/
+static void fcfs_lanes_scalar(const int *arrival, const int *burst, int steps,
+                              int lanes, long long *wait) {
+  for (int l = 0; l < lanes; l++) {
+    int cycle = 0;
+    long long total = 0;
+    for (int k = 0; k < steps; k++) {
+      int a = arrival[k * lanes + l];
+      int start = cycle > a ? cycle : a;
+      total += start - a;
+      cycle = start + burst[k * lanes + l];
+    }
+    wait[l] = total;
+  }
+}
+
+#ifdef SCH_X86
+__attribute__((target("avx2")))
+static void fcfs_lanes_avx2(const int *arrival, const int *burst, int steps,
+                            int lanes, long long *wait) {
+  __m256i cycle = _mm256_setzero_si256();
+  __m256i low = _mm256_setzero_si256(), high = _mm256_setzero_si256();
+  for (int k = 0; k < steps; k++) {
+    __m256i a = _mm256_loadu_si256((const __m256i*) &arrival[k * lanes]);
+    __m256i start = _mm256_max_epi32(cycle, a);
+    __m256i w = _mm256_sub_epi32(start, a);
+    low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(w)));
+    high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(w, 1)));
+    cycle = _mm256_add_epi32(start, _mm256_loadu_si256((const __m256i*) &burst[k * lanes]));
+  }
+  _mm256_storeu_si256((__m256i*) &wait[0], low);
+  _mm256_storeu_si256((__m256i*) &wait[4], high);
+}
+
+__attribute__((target("avx512f")))
+static void fcfs_lanes_avx512(const int *arrival, const int *burst, int steps,
+                              int lanes, long long *wait) {
+  __m512i cycle = _mm512_setzero_si512();
+  __m512i low = _mm512_setzero_si512(), high = _mm512_setzero_si512();
+  for (int k = 0; k < steps; k++) {
+    __m512i a = _mm512_loadu_si512(&arrival[k * lanes]);
+    __m512i start = _mm512_max_epi32(cycle, a);
+    __m512i w = _mm512_sub_epi32(start, a);
+    low = _mm512_add_epi64(low, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(w)));
+    high = _mm512_add_epi64(high, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(w, 1)));
+    cycle = _mm512_add_epi32(start, _mm512_loadu_si512(&burst[k * lanes]));
+  }
+  _mm512_storeu_si512(&wait[0], low);
+  _mm512_storeu_si512(&wait[8], high);
+}
+#endif
+
+/**
+   Compute the solutions to many small scheduling problems with First
+   Come First Served, the same as sch_fcfs on each one. The problems are
+   sorted one by one, then taken by groups of as many problems as SIMD
+   lanes: the jobs of a group are interleaved so that one vector step
+   starts the next job of every problem. A problem with negative arrivals
+   or finish times not fitting in an int is computed alone in 64 bits.
+
+   @param batch the address of the problems to solve, not modified
+
+   @return the array of the batch->count solutions, free it with
+           sch_batch_solutions_free
+ */
+sch_solution * sch_fcfs_batch(sch_batch_problem *batch) {
+  if(SCH_VERBOSE)
+    printf("*********** FCFS (batch of %d)\n", batch->count);
+
+  void (*kernel)(const int*, const int*, int, int, long long*) = fcfs_lanes_scalar;
+  int lanes = 8;
+#ifdef SCH_X86
+  if (__builtin_cpu_supports("avx512f")) {
+    kernel = fcfs_lanes_avx512;
+    lanes = 16;
+  } else if (__builtin_cpu_supports("avx2")) {
+    kernel = fcfs_lanes_avx2;
+  }
+#endif
+
+  int longest = 1;
+  for (int p = 0; p < batch->count; p++) {
+    if (batch->first[p + 1] - batch->first[p] > longest)
+      longest = batch->first[p + 1] - batch->first[p];
+  }
+  sch_solution *sols = (sch_solution*) malloc(sizeof(sch_solution) * (batch->count > 0 ? batch->count : 1));
+  int *orders = (int*) malloc(sizeof(int) * (batch->jobs > 0 ? batch->jobs : 1));
+  batch_job *jobs = (batch_job*) malloc(sizeof(batch_job) * longest);
+  int *arrival = (int*) malloc(sizeof(int) * (size_t) lanes * longest);
+  int *burst = (int*) malloc(sizeof(int) * (size_t) lanes * longest);
+  int group[BATCH_MAX_LANES];
+  long long wait[BATCH_MAX_LANES];
+
+  sols[0].order = orders;
+  int size = 0, steps = 0;
+  for (int p = 0; p <= batch->count; p++) {
+    if (p < batch->count) {
+      int first = batch->first[p], num = batch->first[p + 1] - first;
+      sch_solution *sol = &sols[p];
+      sol->num = num;
+      sol->order = &orders[first];
+      sol->wait_total = 0;
+      sol->wait_average = 0.0;
+
+      // bound of the last finish time
+      long long last = 0;
+      for (int j = 0; j < num; j++) {
+        // multiplied: shifting a negative arrival is undefined
+        jobs[j].key = batch->arrival[first + j] * 4294967296LL +
+                      (unsigned int) (batch->id[first + j] ^ INT_MIN);
+        jobs[j].burst = batch->burst[first + j];
+        last += jobs[j].burst;
+      }
+      batch_sort(jobs, num);
+      for (int j = 0; j < num; j++)
+        sol->order[j] = (int) jobs[j].key ^ INT_MIN;
+      int lowest = num > 0 ? (int) (jobs[0].key >> 32) : 0;
+      int highest = num > 0 ? (int) (jobs[num - 1].key >> 32) : 0;
+      last += highest > 0 ? highest : 0;
+
+      if (last >= INT_MAX || lowest < 0) {
+        long long cycle = 0, wait_time = 0;
+        for (int j = 0; j < num; j++) {
+          long long a = jobs[j].key >> 32;
+          long long start = cycle > a ? cycle : a;
+          wait_time += start - a;
+          cycle = start + jobs[j].burst;
+        }
+        sol->wait_total = wait_time;
+        if (num > 0)
+          sol->wait_average = (double) wait_time / num;
+        continue;
+      }
+
+      int l = size++;
+      group[l] = p;
+      for (int j = 0; j < num; j++) {
+        arrival[j * lanes + l] = (int) (jobs[j].key >> 32);
+        burst[j * lanes + l] = jobs[j].burst;
+      }
+      for (int j = num; j < steps; j++) {
+        arrival[j * lanes + l] = INT_MAX;
+        burst[j * lanes + l] = 0;
+      }
+      // a longer problem pads the previous lanes of the group
+      for (; steps < num; steps++) {
+        for (int m = 0; m < l; m++) {
+          arrival[steps * lanes + m] = INT_MAX;
+          burst[steps * lanes + m] = 0;
+        }
+      }
+      if (size < lanes)
+        continue;
+    }
+    if (size == 0)
+      continue;
+
+    for (int l = size; l < lanes; l++) {
+      for (int j = 0; j < steps; j++) {
+        arrival[j * lanes + l] = INT_MAX;
+        burst[j * lanes + l] = 0;
+      }
+    }
+    kernel(arrival, burst, steps, lanes, wait);
+    for (int l = 0; l < size; l++) {
+      sch_solution *sol = &sols[group[l]];
+      sol->wait_total = wait[l];
+      if (sol->num > 0)
+        sol->wait_average = (double) wait[l] / sol->num;
+    }
+    size = 0;
+    steps = 0;
+  }
+
+  free(jobs);
+  free(arrival);
+  free(burst);
+  return sols;
+}
+
+/**
+   Frees the solutions returned by sch_fcfs_batch.
+
+   @param sols the array of solutions
+ */
+void sch_batch_solutions_free(sch_solution *sols) {
+  free(sols[0].order);
+  free(sols);
+}
+
+/**
+   Checks the cores of sch_cores: without a core or with a core that
+   never progresses, the jobs would never finish.
+
+   @return 1 if there is a core and all the speeds are positive, 0 otherwise
+ */
+static int cores_valid(int cores, int *speed) {
+  if (cores < 1 || speed == NULL)
+    return 0;
+  for (int c = 0; c < cores; c++)
+    if (speed[c] < 1)
+      return 0;
+  return 1;
+}
+
+/**
+   Compute the solution to a scheduling problem on several cores of
+   different speeds. The order is the order in which the jobs start.
+
+   @param sch the address of the scheduling problem to solve
+   @param cores the number of cores
+   @param speed the speed of each core, in percent of the single CPU
+   @param placement PLACE_FASTEST, PLACE_LEAST_LOADED or PLACE_SJF_FAST
+   @param report the address where to store the use of each core,
+          or NULL. Free it with sch_core_report_free.
+
+   @return the address of the computer scheduling solution, or NULL if
+           there is no core or a core does not have a positive speed
+ */
+sch_solution * sch_cores(sch_problem *sch, int cores, int *speed, int placement,
+                         sch_core_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** %d CORES\n", cores);
+  info_table("sch_cores",sch->num,sch->table);
+  if (!cores_valid(cores, speed))
+    return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_cores(sch,sol,cores,speed,placement,NULL,OUTAGE_DEFER,report);
+
+  return sol;
+}
+
+/**
+   Compute the solution to a scheduling problem on several cores of
+   different speeds that are down during outages. The order is the order
+   in which the jobs are given a core, their waits include the cycles
+   lost to the outages.
+
+   @param sch the address of the scheduling problem to solve
+   @param cores the number of cores
+   @param speed the speed of each core, in percent of the single CPU
+   @param placement PLACE_FASTEST, PLACE_LEAST_LOADED or PLACE_SJF_FAST
+   @param outages the outages of the cores cores
+   @param policy OUTAGE_DEFER or OUTAGE_RESUME
+   @param report the address where to store the use of each core,
+          or NULL. Free it with sch_core_report_free.
+
+   @return the address of the computer scheduling solution, or NULL if the
+           cores are not valid, as for sch_cores, or the outages are not
+           of cores cores
+ */
+sch_solution * sch_cores_outages(sch_problem *sch, int cores, int *speed, int placement,
+                                 sch_outages *outages, int policy,
+                                 sch_core_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** %d CORES, %d OUTAGES\n", cores, outages->intervals);
+  info_table("sch_cores_outages",sch->num,sch->table);
+  if (!cores_valid(cores, speed) || outages->cores != cores)
+    return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  execute_cores(sch,sol,cores,speed,placement,outages,policy,report);
+
+  return sol;
+}
+
+/**
+   Frees the arrays of a report filled by sch_cores.
+
+   @param report the address of the report
+ */
+void sch_core_report_free(sch_core_report *report) {
+  free(report->jobs);
+  free(report->busy);
+  free(report->wait);
+  free(report->down);
+  free(report->utilization);
+}
+
+typedef struct {
+  long long start;
+  long long end;
+} outage_interval;
+
+static int outage_interval_compare(const void *a, const void *b) {
+  long long x = ((const outage_interval*) a)->start;
+  long long y = ((const outage_interval*) b)->start;
+  return x < y ? -1 : x > y;
+}
+
+/**
+   Builds the outages of cores from a list of intervals [start[e], end[e])
+   of core core[e], in any order. Overlapping or touching outages of a
+   core are merged, empty ones and ones of no core are ignored.
+
+   @param cores the number of cores
+   @param count the number of intervals
+   @param core the core of each interval
+   @param start the first cycle of each interval
+   @param end the cycle after the last one of each interval
+
+   @return the address of the outages
+ */
+sch_outages * sch_outages_from_intervals(int cores, int count, int *core,
+                                         long long *start, long long *end) {
+  sch_outages *outages = (sch_outages*) malloc(sizeof(sch_outages));
+  outages->cores = cores;
+  outages->first = (int*) calloc(cores + 1, sizeof(int));
+  outages->start = (long long*) malloc(sizeof(long long) * (count > 0 ? count : 1));
+  outages->end = (long long*) malloc(sizeof(long long) * (count > 0 ? count : 1));
+  int *first = outages->first;
+  for (int e = 0; e < count; e++) {
+    if (core[e] >= 0 && core[e] < cores && start[e] < end[e])
+      first[core[e] + 1]++;
+  }
+  for (int c = 0; c < cores; c++) {
+    first[c + 1] += first[c];
+  }
+  // Counting sort by core with first[] as the cursor of each core, then
+  // shift it back.
+  outage_interval *sorted = (outage_interval*) malloc(sizeof(outage_interval) * (count > 0 ? count : 1));
+  for (int e = 0; e < count; e++) {
+    if (core[e] >= 0 && core[e] < cores && start[e] < end[e])
+      sorted[first[core[e]]++] = (outage_interval) { start[e], end[e] };
+  }
+  for (int c = cores; c > 0; c--) {
+    first[c] = first[c - 1];
+  }
+  first[0] = 0;
+
+  int n = 0;
+  for (int c = 0; c < cores; c++) {
+    int from = first[c], to = first[c + 1];
+    qsort(sorted + from, to - from, sizeof(outage_interval), outage_interval_compare);
+    first[c] = n;
+    for (int i = from; i < to; i++) {
+      if (n > first[c] && sorted[i].start <= outages->end[n - 1]) {
+        if (sorted[i].end > outages->end[n - 1])
+          outages->end[n - 1] = sorted[i].end;
+      } else {
+        outages->start[n] = sorted[i].start;
+        outages->end[n] = sorted[i].end;
+        n++;
+      }
+    }
+  }
+  first[cores] = n;
+  outages->intervals = n;
+  free(sorted);
+  return outages;
+}
+
+/**
+   Frees outages.
+
+   @param outages the address of the outages
+ */
+void sch_outages_free(sch_outages *outages) {
+  free(outages->first);
+  free(outages->start);
+  free(outages->end);
+  free(outages);
+}
+
+/*
+  State of the cores shared by the heaps of execute_cores.
+*/
+typedef struct {
+  int *speed;
+  long long *busy;
+  long long *done_at;
+  int placement;
+} cores_ctx;
+
+static int core_idle_less(int a, int b, void *ctx) {
+  cores_ctx *cc = (cores_ctx*) ctx;
+  if (cc->placement == PLACE_LEAST_LOADED) {
+    if (cc->busy[a] != cc->busy[b])
+      return cc->busy[a] < cc->busy[b];
+  } else if (cc->speed[a] != cc->speed[b]) {
+    return cc->speed[a] > cc->speed[b];
+  }
+  return a < b;
+}
+
+static int core_busy_less(int a, int b, void *ctx) {
+  cores_ctx *cc = (cores_ctx*) ctx;
+  if (cc->done_at[a] != cc->done_at[b])
+    return cc->done_at[a] < cc->done_at[b];
+  return a < b;
+}
+
+static int sjf_less(int a, int b, void *ctx) {
+  int **table = (int**) ctx;
+  if (table[a][TBL_BURST] != table[b][TBL_BURST])
+    return table[a][TBL_BURST] < table[b][TBL_BURST];
+  return table[a][TBL_ID] < table[b][TBL_ID];
+}
+
+/*
+  Outages of execute_cores prepared for searches in O(log k) on a core of
+  k outages. down[first[c] + c + i] is the length of the outages of core
+  c before its outage i, for i from 0 to k. The gaps between its outages,
+  start[i] - end[i-1] for i from 1, are the leaves of a segment tree of
+  their max, of leaves[c] leaves (a power of 2), in tree[tree_first[c] +
+  1 ..] with the children of node n at 2n and 2n+1.
+*/
+typedef struct {
+  sch_outages *outages;
+  long long *down;
+  long long *tree;
+  int *tree_first;
+  int *leaves;
+} outage_index;
+
+static void outage_index_build(outage_index *ix, sch_outages *outages) {
+  int cores = outages->cores;
+  ix->outages = outages;
+  ix->down = (long long*) malloc(sizeof(long long) * (outages->intervals + cores));
+  ix->tree_first = (int*) malloc(sizeof(int) * cores);
+  ix->leaves = (int*) malloc(sizeof(int) * cores);
+  int nodes = 0;
+  for (int c = 0; c < cores; c++) {
+    int k = outages->first[c + 1] - outages->first[c], leaves = 1;
+    while (leaves < k)
+      leaves *= 2;
+    ix->leaves[c] = leaves;
+    ix->tree_first[c] = nodes;
+    nodes += 2 * leaves;
+  }
+  ix->tree = (long long*) malloc(sizeof(long long) * nodes);
+
+  for (int c = 0; c < cores; c++) {
+    int first = outages->first[c], k = outages->first[c + 1] - first;
+    long long *down = ix->down + first + c;
+    long long *tree = ix->tree + ix->tree_first[c];
+    int leaves = ix->leaves[c];
+    down[0] = 0;
+    for (int i = 0; i < k; i++) {
+      down[i + 1] = down[i] + outages->end[first + i] - outages->start[first + i];
+    }
+    for (int i = 0; i < leaves; i++) {
+      tree[leaves + i] = i > 0 && i < k ?
+        outages->start[first + i] - outages->end[first + i - 1] : -1;
+    }
+    for (int n = leaves - 1; n > 0; n--) {
+      tree[n] = tree[2 * n] > tree[2 * n + 1] ? tree[2 * n] : tree[2 * n + 1];
+    }
+  }
+}
+
+static void outage_index_free(outage_index *ix) {
+  free(ix->down);
+  free(ix->tree);
+  free(ix->tree_first);
+  free(ix->leaves);
+}
+
+/**
+   Finds the first outage of core c ending after cycle, by binary search.
+
+   @return its index in outages, or first[c+1] if there is none
+ */
+static int outage_next(sch_outages *outages, int c, long long cycle) {
+  int lo = outages->first[c], hi = outages->first[c + 1];
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (outages->end[mid] > cycle)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+/**
+   Finds the first gap from leaf from of at least length cycles in the
+   subtree of node, whose leaves are lo .. hi.
+
+   @return the index of the gap, or -1 if there is none
+ */
+static int outage_gap(long long *tree, int node, int lo, int hi, int from,
+                      long long length) {
+  if (hi < from || tree[node] < length)
+    return -1;
+  if (lo == hi)
+    return lo;
+  int mid = lo + (hi - lo) / 2;
+  int gap = outage_gap(tree, 2 * node, lo, mid, from, length);
+  return gap >= 0 ? gap : outage_gap(tree, 2 * node + 1, mid + 1, hi, from, length);
+}
+
+/**
+   Computes when a job of length cycles given at cycle to core c, up at
+   cycle, starts with OUTAGE_DEFER: the first cycle from which the core
+   is up for length cycles.
+ */
+static long long outage_defer(outage_index *ix, int c, long long cycle, long long length) {
+  sch_outages *outages = ix->outages;
+  int first = outages->first[c], last = outages->first[c + 1];
+  int next = outage_next(outages, c, cycle);
+  if (next == last || outages->start[next] - cycle >= length)
+    return cycle;
+  int gap = outage_gap(ix->tree + ix->tree_first[c], 1, 0, ix->leaves[c] - 1,
+                       next - first + 1, length);
+  return outages->end[gap >= 0 ? first + gap - 1 : last - 1];
+}
+
+/**
+   Computes when a job of length cycles started at cycle on core c, up at
+   cycle, finishes with OUTAGE_RESUME: when the core was up for length
+   cycles since cycle.
+ */
+static long long outage_resume(outage_index *ix, int c, long long cycle, long long length) {
+  sch_outages *outages = ix->outages;
+  int first = outages->first[c], k = outages->first[c + 1] - first;
+  long long *down = ix->down + first + c;
+  int lo = outage_next(outages, c, cycle) - first, hi = k;
+  // cycles the core is up from 0 to the end of the job
+  long long up = cycle - down[lo] + length;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (outages->start[first + mid] - down[mid] >= up)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return up + down[lo];
+}
+
+/**
+   Executes the schedule on several cores. The idle cores are kept in a
+   heap ordered by the placement policy and the busy ones in a heap
+   ordered by the end of their job, so each job costs O(log cores). The
+   time a job takes on a core is computed once from its speed and the
+   simulation jumps from event to event.
+   An idle core found in an outage when it is chosen goes to the busy
+   heap until the end of the outage. The start of a deferred job and the
+   end of a resumed one are searched among the outages of its core, so
+   a job costs O(log k) more for k outages, however long they are.
+   The start order and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param cores is the number of cores
+   @param speed is the speed of each core, in percent
+   @param placement is the placement policy
+   @param outages is the outages of the cores, or NULL
+   @param policy is OUTAGE_DEFER or OUTAGE_RESUME
+   @param report is the core report to fill, or NULL
+ */
+void execute_cores(sch_problem *sch, sch_solution *sol, int cores, int *speed,
+                   int placement, sch_outages *outages, int policy,
+                   sch_core_report *report) {
+  sch_table_sort(sch->num,sch->table,TBL_ARRIVAL);
+
+  cores_ctx cc;
+  cc.speed = (int*) malloc(sizeof(int) * cores);
+  cc.busy = (long long*) calloc(cores, sizeof(long long));
+  cc.done_at = (long long*) malloc(sizeof(long long) * cores);
+  cc.placement = placement;
+  int *jobs = (int*) calloc(cores, sizeof(int));
+  long long *wait = (long long*) calloc(cores, sizeof(long long));
+  sch_heap idle = { 0, (int*) malloc(sizeof(int) * cores), core_idle_less, &cc };
+  sch_heap running = { 0, (int*) malloc(sizeof(int) * cores), core_busy_less, &cc };
+  for (int c = 0; c < cores; c++) {
+    cc.speed[c] = speed[c] > 0 ? speed[c] : 1;
+    heap_push(&idle, c);
+  }
+
+  // Ready jobs: rows head .. job_id-1 for FCFS, a heap of rows for SJF.
+  int sort_by_burst = placement == PLACE_SJF_FAST;
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * sch->num), sjf_less, sch->table };
+  int head = 0;
+  outage_index ix = {0};
+  if (outages != NULL)
+    outage_index_build(&ix, outages);
+
+  int job_id = 0, order_id = 0;
+  long long cycle = 0, wait_time = 0, makespan = 0;
+  while (order_id < sch->num) {
+    while (running.size > 0 && cc.done_at[running.items[0]] <= cycle) {
+      heap_push(&idle, heap_pop(&running));
+    }
+    while ((job_id < sch->num) && (sch->table[job_id][TBL_ARRIVAL] <= cycle)) {
+      if (sort_by_burst)
+        heap_push(&ready, job_id);
+      job_id++;
+    }
+
+    int has_ready = sort_by_burst ? ready.size > 0 : head < job_id;
+    if (has_ready && idle.size > 0) {
+      int c = heap_pop(&idle);
+      if (outages != NULL) {
+        int next = outage_next(outages, c, cycle);
+        if (next < outages->first[c + 1] && outages->start[next] <= cycle) {
+          cc.done_at[c] = outages->end[next];
+          heap_push(&running, c);
+          continue;
+        }
+      }
+      int *job = sch->table[sort_by_burst ? heap_pop(&ready) : head++];
+      long long length = ((long long) job[TBL_BURST] * 100 + cc.speed[c] - 1) / cc.speed[c];
+      long long start = cycle, finish = cycle + length;
+      if (outages != NULL && policy == OUTAGE_RESUME) {
+        finish = outage_resume(&ix, c, cycle, length);
+      } else if (outages != NULL) {
+        start = outage_defer(&ix, c, cycle, length);
+        finish = start + length;
+      }
+      if (SCH_VERBOSE) {
+        printf("(  %lld) Running job %d on core %d from %lld to %lld.\n",
+          cycle, job[TBL_ID], c, start, finish);
+      }
+      // the cycles the job is stopped by outages are waits too
+      long long job_wait = finish - length - job[TBL_ARRIVAL];
+      cc.busy[c] += length;
+      cc.done_at[c] = finish;
+      heap_push(&running, c);
+      if (cc.done_at[c] > makespan)
+        makespan = cc.done_at[c];
+      jobs[c]++;
+      wait[c] += job_wait;
+      wait_time += job_wait;
+      sol->order[order_id] = job[TBL_ID];
+      order_id++;
+      continue;
+    }
+
+    // Jump to the next arrival or end of a job, whichever comes first.
+    long long next_cycle = -1;
+    if (job_id < sch->num)
+      next_cycle = sch->table[job_id][TBL_ARRIVAL];
+    if (running.size > 0 && (next_cycle < 0 || cc.done_at[running.items[0]] < next_cycle))
+      next_cycle = cc.done_at[running.items[0]];
+    cycle = next_cycle;
+  }
+
+  sol->wait_total = wait_time;
+  if (sch->num > 0) {
+    sol->wait_average = (double) wait_time / sch->num;
+  }
+  if (report != NULL) {
+    report->cores = cores;
+    report->jobs = jobs;
+    report->busy = cc.busy;
+    report->wait = wait;
+    report->makespan = makespan;
+    report->down = (long long*) calloc(cores, sizeof(long long));
+    report->utilization = (float*) malloc(sizeof(float) * cores);
+    for (int c = 0; c < cores; c++) {
+      report->utilization[c] = makespan > 0 ? (double) cc.busy[c] / makespan : 0.0;
+      if (outages != NULL) {
+        int next = outage_next(outages, c, makespan);
+        report->down[c] = ix.down[next + c];
+        if (next < outages->first[c + 1] && outages->start[next] < makespan)
+          report->down[c] += makespan - outages->start[next];
+      }
+    }
+  } else {
+    free(jobs);
+    free(cc.busy);
+    free(wait);
+  }
+
+  free(cc.speed);
+  free(cc.done_at);
+  free(idle.items);
+  free(running.items);
+  free(ready.items);
+  if (outages != NULL)
+    outage_index_free(&ix);
+}
+
+/**
+   Builds a DAG from a list of edges parent[e] -> child[e] between the
+   rows of a table, with a counting sort by parent.
+
+   @param num the number of jobs
+   @param edges the number of edges
+   @param parent the row of the parent of each edge
+   @param child the row of the child of each edge
+
+   @return the address of the DAG, or NULL if an edge is not between two
+           rows of [0, num)
+ */
+sch_dag * sch_dag_from_edges(int num, int edges, int *parent, int *child) {
+  if (num < 0 || edges < 0)
+    return NULL;
+  for (int e = 0; e < edges; e++) {
+    if (parent[e] < 0 || parent[e] >= num || child[e] < 0 || child[e] >= num)
+      return NULL;
+  }
+  sch_dag *dag = (sch_dag*) malloc(sizeof(sch_dag));
+  dag->num = num;
+  dag->edges = edges;
+  dag->first = (int*) calloc(num + 1, sizeof(int));
+  dag->child = (int*) malloc(sizeof(int) * edges);
+  for (int e = 0; e < edges; e++) {
+    dag->first[parent[e] + 1]++;
+  }
+  for (int i = 0; i < num; i++) {
+    dag->first[i + 1] += dag->first[i];
+  }
+  // Fill with first[] as the cursor of each parent, then shift it back.
+  for (int e = 0; e < edges; e++) {
+    dag->child[dag->first[parent[e]]++] = child[e];
+  }
+  for (int i = num; i > 0; i--) {
+    dag->first[i] = dag->first[i - 1];
+  }
+  dag->first[0] = 0;
+  return dag;
+}
+
+/**
+   Frees a DAG.
+
+   @param dag the address of the DAG
+ */
+void sch_dag_free(sch_dag *dag) {
+  free(dag->first);
+  free(dag->child);
+  free(dag);
+}
+
+/**
+   Compute the solution to a scheduling problem whose jobs depend on each
+   other. A job is ready once it arrived and all its parents finished,
+   and waits from then until it starts. The table is not reordered, so
+   the rows keep matching the nodes of the DAG.
+
+   @param sch the address of the scheduling problem to solve
+   @param dag the dependencies between the rows of sch->table
+   @param policy DAG_FCFS, DAG_SJF or DAG_CRITICAL_PATH
+   @param report the address where to store the makespan and critical
+          path length, or NULL
+
+   @return the address of the computer scheduling solution, or NULL if
+           the DAG is not of sch->num jobs or the dependencies have a cycle
+ */
+sch_solution * sch_dag_schedule(sch_problem *sch, sch_dag *dag, int policy,
+                                sch_dag_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** DAG\n");
+  info_table("sch_dag_schedule",sch->num,sch->table);
+  if (dag->num != sch->num)
+    return NULL;
+
+  sch_solution *sol = (sch_solution*) malloc(sizeof(sch_solution));
+  sol->num = sch->num;
+  sch_solution_malloc(sol);
+
+  if (!execute_dag(sch,dag,sol,policy,report)) {
+    if(SCH_VERBOSE)
+      printf("The dependencies have a cycle.\n");
+    free(sol->order);
+    free(sol);
+    return NULL;
+  }
+
+  return sol;
+}
+
+/*
+  Data the order of the ready jobs of a DAG depends on.
+*/
+typedef struct {
+  int **table;
+  long long *ready_at;
+  long long *level;
+  int policy;
+} dag_ctx;
+
+static int dag_less(int a, int b, void *ctx) {
+  dag_ctx *dc = (dag_ctx*) ctx;
+  if (dc->policy == DAG_FCFS && dc->ready_at[a] != dc->ready_at[b])
+    return dc->ready_at[a] < dc->ready_at[b];
+  if (dc->policy == DAG_SJF && dc->table[a][TBL_BURST] != dc->table[b][TBL_BURST])
+    return dc->table[a][TBL_BURST] < dc->table[b][TBL_BURST];
+  if (dc->policy == DAG_CRITICAL_PATH && dc->level[a] != dc->level[b])
+    return dc->level[a] > dc->level[b];
+  return dc->table[a][TBL_ID] < dc->table[b][TBL_ID];
+}
+
+/**
+   Stores the rows of a table by arrival time, then ID.
+
+   @param num the number of rows
+   @param table the rows
+   @param index the address where to store the num row indices
+ */
+static void sort_rows_by_arrival(int num, int **table, int *index) {
+  sort_entry *entries = (sort_entry*) malloc(sizeof(sort_entry) * (num > 0 ? num : 1));
+  for (int i = 0; i < num; i++) {
+    entries[i] = (sort_entry){ table[i][TBL_ARRIVAL], table[i][TBL_ID], i };
+  }
+  sort_entries(num, entries, index);
+  free(entries);
+}
+
+/**
+   Executes the schedule of jobs with dependencies. Kahn's algorithm with
+   in-degree counters gives a topological order, walked backwards to get
+   the longest path from each job to the end of the DAG. The simulation
+   then decrements the counters of the children of each finished job, a
+   job becoming ready when its counter reaches 0 after its arrival. Each
+   edge is visited once by each step.
+   The order and avg. wait time are stored in sol.
+
+   @param sch is the problem containing all the processes to schedule
+   @param dag is the DAG of the dependencies between the rows of sch
+   @param sol is the solution that will be storing the order and avg. wait time
+   @param policy is the policy choosing the next ready job
+   @param report is the report to fill, or NULL
+
+   @return 1 on success, 0 if the DAG has a cycle
+ */
+int execute_dag(sch_problem *sch, sch_dag *dag, sch_solution *sol, int policy,
+                sch_dag_report *report) {
+  int n = sch->num;
+  int *parents = (int*) calloc(n, sizeof(int));
+  int *waiting = (int*) malloc(sizeof(int) * n);
+  int *topo = (int*) malloc(sizeof(int) * n);
+  long long *level = (long long*) malloc(sizeof(long long) * n);
+  for (int e = 0; e < dag->edges; e++) {
+    parents[dag->child[e]]++;
+  }
+
+  // Topological order, topo[] doubling as the queue of Kahn's algorithm.
+  int size = 0;
+  for (int i = 0; i < n; i++) {
+    waiting[i] = parents[i];
+    if (waiting[i] == 0)
+      topo[size++] = i;
+  }
+  for (int k = 0; k < size; k++) {
+    for (int e = dag->first[topo[k]]; e < dag->first[topo[k] + 1]; e++) {
+      if (--waiting[dag->child[e]] == 0)
+        topo[size++] = dag->child[e];
+    }
+  }
+  if (size < n) {
+    free(parents);
+    free(waiting);
+    free(topo);
+    free(level);
+    return 0;
+  }
+
+  long long critical_path = 0;
+  for (int k = n - 1; k >= 0; k--) {
+    int v = topo[k];
+    long long longest = 0;
+    for (int e = dag->first[v]; e < dag->first[v + 1]; e++) {
+      if (level[dag->child[e]] > longest)
+        longest = level[dag->child[e]];
+    }
+    level[v] = sch->table[v][TBL_BURST] + longest;
+    if (level[v] > critical_path)
+      critical_path = level[v];
+  }
+
+  // Rows by arrival time, then ID, reusing topo.
+  int *by_arrival = topo;
+  sort_rows_by_arrival(n, sch->table, by_arrival);
+
+  long long *ready_at = (long long*) calloc(n, sizeof(long long));
+  char *arrived = (char*) calloc(n, sizeof(char));
+  dag_ctx dc = { sch->table, ready_at, level, policy };
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * n), dag_less, &dc };
+
+  int job_id = 0, order_id = 0;
+  long long cycle = 0, wait_time = 0;
+  while (order_id < n) {
+    while (job_id < n && sch->table[by_arrival[job_id]][TBL_ARRIVAL] <= cycle) {
+      int v = by_arrival[job_id++];
+      arrived[v] = 1;
+      if (ready_at[v] < sch->table[v][TBL_ARRIVAL])
+        ready_at[v] = sch->table[v][TBL_ARRIVAL];
+      if (parents[v] == 0)
+        heap_push(&ready, v);
+    }
+
+    if (ready.size == 0) {
+      cycle = sch->table[by_arrival[job_id]][TBL_ARRIVAL];
+      continue;
+    }
+
+    int v = heap_pop(&ready);
+    int *job = sch->table[v];
+    if (SCH_VERBOSE) {
+      printf("(  %lld) Running job %d, ready at %lld, with burst time %d.\n",
+        cycle, job[TBL_ID], ready_at[v], job[TBL_BURST]);
+    }
+    wait_time += cycle - ready_at[v];
+    cycle += job[TBL_BURST];
+    sol->order[order_id] = job[TBL_ID];
+    order_id++;
+
+    for (int e = dag->first[v]; e < dag->first[v + 1]; e++) {
+      int c = dag->child[e];
+      if (ready_at[c] < cycle)
+        ready_at[c] = cycle;
+      if (--parents[c] == 0 && arrived[c])
+        heap_push(&ready, c);
+    }
+  }
+
+  sol->wait_total = wait_time;
+  if (n > 0) {
+    sol->wait_average = (double) wait_time / n;
+  }
+  if (report != NULL) {
+    report->makespan = cycle;
+    report->critical_path = critical_path;
+  }
+
+  free(parents);
+  free(waiting);
+  free(topo);
+  free(level);
+  free(ready_at);
+  free(arrived);
+  free(ready.items);
+  return 1;
+}
+
+#define EST_CLASSES 33
+
+/**
+   Estimates the average waits of FCFS and SJF from one pass over the
+   table: count, first and last arrival, sum and sum of squares of the
+   bursts, and the load of each class of bursts in [2^(k-1), 2^k). The
+   table is not reordered.
+
+   @param sch the address of the scheduling problem
+   @param est the address where to store the estimate
+ */
+void sch_estimate_waits(sch_problem *sch, sch_estimate *est) {
+  double class_jobs[EST_CLASSES] = {0}, class_work[EST_CLASSES] = {0};
+  double sum = 0, sum2 = 0;
+  int first = 0, last = 0;
+  for (int i = 0; i < sch->num; i++) {
+    int *job = sch->table[i];
+    double burst = job[TBL_BURST] > 0 ? job[TBL_BURST] : 0;
+    int k = 0;
+    for (unsigned int b = (unsigned int) burst; b > 0; b >>= 1)
+      k++;
+    class_jobs[k] += 1;
+    class_work[k] += burst;
+    sum += burst;
+    sum2 += burst * burst;
+    if (i == 0 || job[TBL_ARRIVAL] < first)
+      first = job[TBL_ARRIVAL];
+    if (i == 0 || job[TBL_ARRIVAL] > last)
+      last = job[TBL_ARRIVAL];
+  }
+
+  est->num = sch->num;
+  est->span = (long long) last - first;
+  est->burst_mean = sch->num > 0 ? sum / sch->num : 0;
+  est->burst_m2 = sch->num > 0 ? sum2 / sch->num : 0;
+  est->arrival_rate = est->span > 0 ? (sch->num - 1) / (double) est->span : 0;
+  est->load = est->arrival_rate * est->burst_mean;
+  est->error_fcfs = 0;
+  est->error_sjf = 0;
+
+  if (est->span == 0) {
+    // A single batch: each job waits for the work run before it, half of
+    // its class and all of the shorter classes for SJF.
+    est->wait_fcfs = sch->num > 0 ? (sch->num - 1) * est->burst_mean / 2 : 0;
+    double wait_sjf = 0, below = 0;
+    for (int k = 0; k < EST_CLASSES; k++) {
+      if (class_jobs[k] == 0)
+        continue;
+      wait_sjf += class_jobs[k] * (below + (class_jobs[k] - 1) * class_work[k] / class_jobs[k] / 2);
+      below += class_work[k];
+    }
+    est->wait_sjf = sch->num > 0 ? wait_sjf / sch->num : 0;
+    return;
+  }
+
+  // Residual work found by an arrival, and the wait once overloaded when
+  // the backlog grows by load - 1 per cycle.
+  double residual = est->arrival_rate * est->burst_m2 / 2;
+  double overloaded = (est->load - 1) * est->span / 2;
+  est->wait_fcfs = est->load < 1 ? residual / (1 - est->load) : overloaded;
+
+  double wait_sjf = 0, below = 0;
+  for (int k = 0; k < EST_CLASSES; k++) {
+    if (class_jobs[k] == 0)
+      continue;
+    double upto = below + est->arrival_rate * class_work[k] / sch->num;
+    double wait_k = upto < 1 ? residual / ((1 - below) * (1 - upto)) : overloaded;
+    wait_sjf += class_jobs[k] / sch->num * wait_k;
+    below = upto;
+  }
+  est->wait_sjf = wait_sjf;
+}
+
+/**
+   Measures the error of an estimate against the exact waits of FCFS and
+   SJF, computed with the packed engine on a copy of the jobs. Used to
+   check on a few candidates that the estimate can be trusted to prune
+   the others.
+
+   @param sch the address of the scheduling problem of the estimate
+   @param est the address of the estimate, error_fcfs and error_sjf are set
+ */
+void sch_estimate_error(sch_problem *sch, sch_estimate *est) {
+  sch_packed_problem *pk = sch_packed_malloc();
+  int **rows = (int**) malloc(sizeof(int*) * (sch->num > 0 ? sch->num : 1));
+  for (int i = 0; i < sch->num; i++) {
+    rows[i] = sch->table[i];
+  }
+  sch_table_sort(sch->num, rows, TBL_ARRIVAL);
+  for (int i = 0; i < sch->num; i++) {
+    sch_packed_append(pk, rows[i][TBL_ID], rows[i][TBL_ARRIVAL], rows[i][TBL_BURST]);
+  }
+  free(rows);
+
+  sch_solution *fcfs = sch_fcfs_packed(pk);
+  sch_solution *sjf = sch_sjf_packed(pk);
+  float diff_fcfs = est->wait_fcfs - fcfs->wait_average;
+  float diff_sjf = est->wait_sjf - sjf->wait_average;
+  est->error_fcfs = fcfs->wait_average > 0 ?
+    (diff_fcfs < 0 ? -diff_fcfs : diff_fcfs) / fcfs->wait_average : 0;
+  est->error_sjf = sjf->wait_average > 0 ?
+    (diff_sjf < 0 ? -diff_sjf : diff_sjf) / sjf->wait_average : 0;
+
+  free(fcfs->order);
+  free(fcfs);
+  free(sjf->order);
+  free(sjf);
+  sch_packed_free(pk);
+}
+
+#define MAILBOX_IDLE     0
+#define MAILBOX_ASSIGNED 1
+#define MAILBOX_STOP     2
+
+#define LIVE_SPINS_BEFORE_SLEEP 64
+#define LIVE_SLEEP_NS 20000
+
+/*
+  Slot through which the dispatcher of sch_live gives a job to a worker.
+  Only the dispatcher writes row and assigned_ns, before it publishes
+  them by setting state to MAILBOX_ASSIGNED; only the worker sets it back
+  to MAILBOX_IDLE.
+*/
+typedef struct {
+  _Atomic int state;
+  int row;
+  long long assigned_ns;
+} live_mailbox;
+
+typedef struct {
+  sch_problem *sch;
+  sch_live_config *config;
+  live_mailbox *mailboxes;
+  long long *started_ns;   // per row
+  long long *latency_ns;   // per row
+  int *order;
+  _Atomic int started;
+  _Atomic int finished;
+} live_state;
+
+typedef struct {
+  live_state *st;
+  int worker;
+} live_worker_arg;
+
+static long long live_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void live_sleep_ns(long long ns) {
+  struct timespec ts = { ns / 1000000000LL, ns % 1000000000LL };
+  nanosleep(&ts, NULL);
+}
+
+/**
+   Waits politely for the other threads: yields a few times, then sleeps
+   a little, so that idle threads do not starve busy ones.
+ */
+static void live_backoff(int *spins) {
+  if (++(*spins) < LIVE_SPINS_BEFORE_SLEEP) {
+    sched_yield();
+  } else {
+    live_sleep_ns(LIVE_SLEEP_NS);
+  }
+}
+
+/**
+   Runs the jobs given in the mailbox of a worker until told to stop.
+ */
+static void * live_worker(void *arg) {
+  live_state *st = ((live_worker_arg*) arg)->st;
+  live_mailbox *box = &st->mailboxes[((live_worker_arg*) arg)->worker];
+  int spins = 0;
+  while (1) {
+    int state = atomic_load_explicit(&box->state, memory_order_acquire);
+    if (state == MAILBOX_STOP)
+      break;
+    if (state != MAILBOX_ASSIGNED) {
+      live_backoff(&spins);
+      continue;
+    }
+    spins = 0;
+
+    int row = box->row;
+    long long now = live_now_ns();
+    st->started_ns[row] = now;
+    st->latency_ns[row] = now - box->assigned_ns;
+    st->order[atomic_fetch_add(&st->started, 1)] = st->sch->table[row][TBL_ID];
+
+    long long length = (long long) st->sch->table[row][TBL_BURST] * st->config->cycle_ns;
+    if (st->config->busy_wait) {
+      while (live_now_ns() - now < length)
+        ;
+    } else if (length > 0) {
+      live_sleep_ns(length);
+    }
+
+    atomic_fetch_add(&st->finished, 1);
+    atomic_store_explicit(&box->state, MAILBOX_IDLE, memory_order_release);
+  }
+  return NULL;
+}
+
+static int live_fcfs_less(int a, int b, void *ctx) {
+  int **table = (int**) ctx;
+  if (table[a][TBL_ARRIVAL] != table[b][TBL_ARRIVAL])
+    return table[a][TBL_ARRIVAL] < table[b][TBL_ARRIVAL];
+  return table[a][TBL_ID] < table[b][TBL_ID];
+}
+
+/**
+   Executes a scheduling problem for real with FCFS or SJF on a pool of
+   worker threads, and measures the waits and the dispatch latency.
+   The calling thread is the dispatcher: it releases the jobs at their
+   arrival time into a heap ordered by the policy, and hands the next one
+   to an idle worker through the worker's mailbox, with atomics only.
+   The table is not reordered.
+
+   @param sch the address of the scheduling problem
+   @param sort_by_burst is used to use the FCFS or SJF algorithms.
+   @param config the number of workers, length of a cycle and kind of work
+   @param report the address where to store the measures.
+          Free it with sch_live_report_free.
+
+   @return 1 on success, 0 if the workers could not be started
+ */
+int sch_live(sch_problem *sch, int sort_by_burst, sch_live_config *config,
+             sch_live_report *report) {
+  int n = sch->num, workers = config->workers > 0 ? config->workers : 1;
+  int size = n > 0 ? n : 1;
+  live_state st;
+  st.sch = sch;
+  st.config = config;
+  st.mailboxes = (live_mailbox*) malloc(sizeof(live_mailbox) * workers);
+  st.started_ns = (long long*) malloc(sizeof(long long) * size);
+  st.latency_ns = (long long*) malloc(sizeof(long long) * size);
+  st.order = (int*) malloc(sizeof(int) * size);
+  atomic_init(&st.started, 0);
+  atomic_init(&st.finished, 0);
+  for (int w = 0; w < workers; w++) {
+    atomic_init(&st.mailboxes[w].state, MAILBOX_IDLE);
+  }
+
+  // Rows by arrival time, and the heap of the released ones.
+  int *by_arrival = (int*) malloc(sizeof(int) * size);
+  sort_rows_by_arrival(n, sch->table, by_arrival);
+  sch_heap ready = { 0, (int*) malloc(sizeof(int) * size),
+                     sort_by_burst ? sjf_less : live_fcfs_less, sch->table };
+  int released = 0;
+
+  pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * workers);
+  live_worker_arg *args = (live_worker_arg*) malloc(sizeof(live_worker_arg) * workers);
+  int created = 0;
+  for (; created < workers; created++) {
+    args[created].st = &st;
+    args[created].worker = created;
+    if (pthread_create(&threads[created], NULL, live_worker, &args[created]) != 0)
+      break;
+  }
+
+  // Arrivals count from the first one, released at once.
+  long long first_arrival = n > 0 ? sch->table[by_arrival[0]][TBL_ARRIVAL] : 0;
+  long long start_ns = live_now_ns() - first_arrival * config->cycle_ns;
+  int spins = 0;
+  while (created == workers && atomic_load(&st.finished) < n) {
+    long long now = live_now_ns();
+    int progress = 0;
+    while (released < n &&
+           sch->table[by_arrival[released]][TBL_ARRIVAL] * config->cycle_ns <= now - start_ns) {
+      heap_push(&ready, by_arrival[released++]);
+      progress = 1;
+    }
+    for (int w = 0; w < workers && ready.size > 0; w++) {
+      if (atomic_load_explicit(&st.mailboxes[w].state, memory_order_acquire) == MAILBOX_IDLE) {
+        st.mailboxes[w].row = heap_pop(&ready);
+        st.mailboxes[w].assigned_ns = live_now_ns();
+        atomic_store_explicit(&st.mailboxes[w].state, MAILBOX_ASSIGNED, memory_order_release);
+        progress = 1;
+      }
+    }
+    if (progress)
+      spins = 0;
+    else
+      live_backoff(&spins);
+  }
+
+  for (int w = 0; w < created; w++) {
+    // All the jobs finished, so every worker is idle.
+    atomic_store_explicit(&st.mailboxes[w].state, MAILBOX_STOP, memory_order_release);
+    pthread_join(threads[w], NULL);
+  }
+
+  if (created == workers) {
+    // Simulation of the same schedule, on a copy of the rows.
+    int *speed = (int*) malloc(sizeof(int) * workers);
+    for (int w = 0; w < workers; w++) {
+      speed[w] = 100;
+    }
+    sch_problem copy;
+    copy.num = n;
+    copy.table = (int**) malloc(sizeof(int*) * size);
+    for (int i = 0; i < n; i++) {
+      copy.table[i] = sch->table[i];
+    }
+    sch_solution *sim = sch_cores(&copy, workers, speed,
+      sort_by_burst ? PLACE_SJF_FAST : PLACE_FASTEST, NULL);
+
+    double wait = 0, latency = 0, latency2 = 0;
+    report->latency_max = 0;
+    for (int i = 0; i < n; i++) {
+      long long arrival_ns = start_ns + sch->table[i][TBL_ARRIVAL] * config->cycle_ns;
+      wait += (double)(st.started_ns[i] - arrival_ns) / config->cycle_ns;
+      latency += st.latency_ns[i];
+      latency2 += (double) st.latency_ns[i] * st.latency_ns[i];
+      if (st.latency_ns[i] > report->latency_max)
+        report->latency_max = st.latency_ns[i];
+    }
+    report->num = n;
+    report->order = st.order;
+    report->wait_average = n > 0 ? wait / n : 0;
+    report->simulated_wait_average = sim->wait_average;
+    report->latency_average = n > 0 ? latency / n : 0;
+    double variance = n > 0 ? latency2 / n - report->latency_average * report->latency_average : 0;
+    report->jitter = variance > 0 ? sqrt(variance) : 0;
+
+    free(sim->order);
+    free(sim);
+    free(copy.table);
+    free(speed);
+  } else {
+    free(st.order);
+  }
+
+  free(threads);
+  free(args);
+  free(by_arrival);
+  free(ready.items);
+  free(st.mailboxes);
+  free(st.started_ns);
+  free(st.latency_ns);
+  return created == workers;
+}
+
+/**
+   Frees the arrays of a report filled by sch_live.
+
+   @param report the address of the report
+ */
+void sch_live_report_free(sch_live_report *report) {
+  free(report->order);
+}
+
+/*
+  Heap of the slots of execute_admission that knows the position of each
+  slot, so that any job can be removed from it.
+*/
+typedef struct {
+  int size;
+  int *items;
+  int *pos;
+  int (*less)(const stream_job *a, const stream_job *b);
+  stream_job *jobs;
+} admit_heap;
+
+static int admit_fcfs_less(const stream_job *a, const stream_job *b) {
+  if (a->arrival != b->arrival)
+    return a->arrival < b->arrival;
+  return a->id < b->id;
+}
+
+static int admit_sjf_less(const stream_job *a, const stream_job *b) {
+  if (a->burst != b->burst)
+    return a->burst < b->burst;
+  return a->id < b->id;
+}
+
+// first the longest job, then the latest one
+static int admit_longest_less(const stream_job *a, const stream_job *b) {
+  if (a->burst != b->burst)
+    return a->burst > b->burst;
+  return admit_fcfs_less(b, a);
+}
+
+static int admit_less(admit_heap *heap, int i, int j) {
+  return heap->less(&heap->jobs[heap->items[i]], &heap->jobs[heap->items[j]]);
+}
+
+static void admit_swap(admit_heap *heap, int i, int j) {
+  int item = heap->items[i];
+  heap->items[i] = heap->items[j];
+  heap->items[j] = item;
+  heap->pos[heap->items[i]] = i;
+  heap->pos[heap->items[j]] = j;
+}
+
+static void admit_sift(admit_heap *heap, int i) {
+  while (i > 0 && admit_less(heap, i, (i - 1) / 2)) {
+    admit_swap(heap, i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+  while (2 * i + 1 < heap->size) {
+    int child = 2 * i + 1;
+    if (child + 1 < heap->size && admit_less(heap, child + 1, child))
+      child++;
+    if (!admit_less(heap, child, i))
+      break;
+    admit_swap(heap, i, child);
+    i = child;
+  }
+}
+
+static void admit_push(admit_heap *heap, int slot) {
+  heap->items[heap->size] = slot;
+  heap->pos[slot] = heap->size++;
+  admit_sift(heap, heap->size - 1);
+}
+
+static void admit_remove(admit_heap *heap, int slot) {
+  int i = heap->pos[slot];
+  heap->size--;
+  if (i < heap->size) {
+    heap->items[i] = heap->items[heap->size];
+    heap->pos[heap->items[i]] = i;
+    admit_sift(heap, i);
+  }
+}
+
+/**
+   Estimates a quantile of the waits counted in a histogram of
+   ADMIT_WAIT_BUCKETS buckets, linearly inside its bucket.
+ */
+static float admit_quantile(long long *histogram, long long num, double q, long long max) {
+  double rank = q * num, before = 0;
+  for (int b = 0; b < ADMIT_WAIT_BUCKETS; b++) {
+    if (histogram[b] > 0 && before + histogram[b] >= rank) {
+      double low = b > 0 ? (double) (1LL << (b - 1)) : 0;
+      double high = b > 0 ? 2 * low - 1 : 0;
+      double wait = low + (high - low) * (rank - before) / histogram[b];
+      return wait < max ? wait : max;
+    }
+    before += histogram[b];
+  }
+  return max;
+}
+
+/**
+   Executes the schedule of the jobs read from src, sorted by arrival time
+   then ID, with a ready queue of config->capacity jobs. The queue is in
+   capacity + 1 slots, the last one for the arriving job, held by a heap
+   ordered by the policy choosing the next job and, unless the arriving
+   job is rejected, a heap ordered by the policy choosing the job to drop:
+   memory does not grow with the number of jobs, and each job costs
+   O(log capacity). The queue only changes at arrivals and dispatches,
+   so the arrivals while a job runs are admitted when it ends, in order,
+   with the queue they would have found.
+
+   @param src is the source of the jobs to schedule
+   @param sort_by_burst is used to use the FCFS or SJF algorithms.
+   @param config is the capacity of the queue and the drop policy
+   @param drop is called with ctx and each dropped job, or NULL
+   @param ctx is passed to drop
+   @param report is the report to fill
+
+   @return 1, or 0 if the configuration is not valid
+ */
+int execute_admission(job_source *src, int sort_by_burst, sch_admission_config *config,
+                      sch_drop_callback drop, void *ctx, sch_admission_report *report) {
+  int capacity = config->capacity, policy = config->policy;
+  if (capacity < 1 || policy < ADMIT_REJECT || policy > ADMIT_DROP_OLDEST)
+    return 0;
+
+  *report = (sch_admission_report) { 0 };
+  stream_job *jobs = (stream_job*) malloc(sizeof(stream_job) * (capacity + 1));
+  int *free_slots = (int*) malloc(sizeof(int) * (capacity + 1));
+  int free_size = 0;
+  for (int slot = capacity; slot >= 0; slot--)
+    free_slots[free_size++] = slot;
+  admit_heap ready = { 0, (int*) malloc(sizeof(int) * (capacity + 1)),
+                       (int*) malloc(sizeof(int) * (capacity + 1)),
+                       sort_by_burst ? admit_sjf_less : admit_fcfs_less, jobs };
+  admit_heap victims = { 0, NULL, NULL,
+                         policy == ADMIT_DROP_LONGEST ? admit_longest_less : admit_fcfs_less, jobs };
+  if (policy != ADMIT_REJECT) {
+    victims.items = (int*) malloc(sizeof(int) * (capacity + 1));
+    victims.pos = (int*) malloc(sizeof(int) * (capacity + 1));
+  }
+
+  long long cycle = 0;
+  stream_job next;
+  int has_next = src->next(src->ctx, &next);
+  while (1) {
+    if (ready.size == 0) {
+      if (!has_next)
+        break;
+      // Nothing ready, jump to the next arrival.
+      if (cycle < next.arrival)
+        cycle = next.arrival;
+    }
+    while (has_next && next.arrival <= cycle) {
+      int slot = free_slots[--free_size];
+      jobs[slot] = next;
+      admit_push(&ready, slot);
+      if (policy != ADMIT_REJECT)
+        admit_push(&victims, slot);
+      report->arrived++;
+      if (ready.size > capacity) {
+        int victim = policy == ADMIT_REJECT ? slot : victims.items[0];
+        admit_remove(&ready, victim);
+        if (policy != ADMIT_REJECT)
+          admit_remove(&victims, victim);
+        free_slots[free_size++] = victim;
+        report->dropped++;
+        if (SCH_VERBOSE) {
+          printf("(  %d) Dropping job %d, arrived at %d, with burst time %d.\n",
+            next.arrival, jobs[victim].id, jobs[victim].arrival, jobs[victim].burst);
+        }
+        if (drop != NULL) {
+          sch_drop_record record = { jobs[victim].id, jobs[victim].arrival,
+                                     jobs[victim].burst, next.arrival };
+          drop(ctx, &record);
+        }
+      }
+      if (ready.size > report->queue_max)
+        report->queue_max = ready.size;
+      has_next = src->next(src->ctx, &next);
+    }
+
+    int slot = ready.items[0];
+    admit_remove(&ready, slot);
+    if (policy != ADMIT_REJECT)
+      admit_remove(&victims, slot);
+    free_slots[free_size++] = slot;
+    stream_job *job = &jobs[slot];
+    if (SCH_VERBOSE) {
+      printf("(  %lld) Running job %d, arrived at %d, with burst time %d.\n",
+        cycle, job->id, job->arrival, job->burst);
+    }
+    long long wait = cycle - job->arrival;
+    report->admitted++;
+    report->wait_total += wait;
+    if (wait > report->wait_max)
+      report->wait_max = wait;
+    report->wait_histogram[wait > 0 ? 64 - __builtin_clzll(wait) : 0]++;
+    cycle += job->burst;
+  }
+
+  report->makespan = report->admitted > 0 ? cycle : 0;
+  if (report->arrived > 0)
+    report->drop_rate = (double) report->dropped / report->arrived;
+  if (report->makespan > 0)
+    report->goodput = (double) report->admitted / report->makespan;
+  if (report->admitted > 0) {
+    report->wait_average = (double) report->wait_total / report->admitted;
+    report->wait_p50 = admit_quantile(report->wait_histogram, report->admitted, 0.5,
+                                      report->wait_max);
+    report->wait_p99 = admit_quantile(report->wait_histogram, report->admitted, 0.99,
+                                      report->wait_max);
+  }
+
+  free(jobs);
+  free(free_slots);
+  free(ready.items);
+  free(ready.pos);
+  free(victims.items);
+  free(victims.pos);
+  return 1;
+}
+
+/**
+   Compute the schedule of a scheduling problem with FCFS or SJF and a
+   ready queue of bounded length, dropping jobs when it is full. The table
+   of sch is sorted by arrival time in place.
+
+   @param sch the address of the scheduling problem to solve
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param config the capacity of the queue and the drop policy
+   @param drop the callback called with ctx and the record of each
+          dropped job, or NULL
+   @param ctx passed to drop
+   @param report the address where to store the result
+
+   @return 1, or 0 if the configuration is not valid
+ */
+int sch_admit(sch_problem *sch, int sort_by_burst, sch_admission_config *config,
+              sch_drop_callback drop, void *ctx, sch_admission_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (queue of %d)\n", sort_by_burst ? "SJF" : "FCFS", config->capacity);
+  info_table("sch_admit",sch->num,sch->table);
+
+  sch_table_sort(sch->num, sch->table, TBL_ARRIVAL);
+  table_reader rd = { sch->table, sch->num, 0 };
+  job_source src = { table_next, &rd };
+  return execute_admission(&src, sort_by_burst, config, drop, ctx, report);
+}
+
+/*
+  Source calling a sch_job_generator.
+*/
+typedef struct {
+  sch_job_generator next;
+  void *ctx;
+} generator_reader;
+
+static int generator_next(void *ctx, stream_job *job) {
+  generator_reader *rd = (generator_reader*) ctx;
+  return rd->next(rd->ctx, &job->id, &job->arrival, &job->burst);
+}
+
+/**
+   Same as sch_admit for jobs generated as they arrive, never all in
+   memory: only the queue is, so the memory does not grow with the number
+   of jobs. The number of jobs is still bounded by their arrivals, which
+   are int: all the jobs must arrive by cycle INT_MAX.
+
+   @param next the generator of the jobs, sorted by arrival time then ID
+   @param next_ctx passed to next
+   @param sort_by_burst 0 for FCFS, 1 for SJF
+   @param config the capacity of the queue and the drop policy
+   @param drop the callback called with ctx and the record of each
+          dropped job, or NULL
+   @param ctx passed to drop
+   @param report the address where to store the result
+
+   @return 1, or 0 if the configuration is not valid
+ */
+int sch_admit_generated(sch_job_generator next, void *next_ctx, int sort_by_burst,
+                        sch_admission_config *config, sch_drop_callback drop,
+                        void *ctx, sch_admission_report *report) {
+  if(SCH_VERBOSE)
+    printf("*********** %s (generated, queue of %d)\n", sort_by_burst ? "SJF" : "FCFS",
+           config->capacity);
+
+  generator_reader rd = { next, next_ctx };
+  job_source src = { generator_next, &rd };
+  return execute_admission(&src, sort_by_burst, config, drop, ctx, report);
+}
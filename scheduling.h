@@ -1,6 +1,11 @@
 #define ID      0
 #define ARRIVAL 1
 #define BURST   2
+#define TICKETS 3
+#define DEADLINE 4
+#define PROCESS 5
+
+#define NO_DEADLINE 2147483647
 
 /*
   Example:
@@ -13,6 +18,14 @@
   |  2  |   0     |  6    |
   |  3  |   5     |  3    |
   -------------------------
+
+  Rows also hold optional columns after BURST. They are set to their
+  default by sch_table_malloc and only read by the policies using them:
+          TICKETS  : share of the CPU for lottery/stride (default 1)
+          DEADLINE : cycle by which the job should be finished, for EDF
+                     (default NO_DEADLINE)
+          PROCESS  : process the job is a burst of, from 0, for the
+                     predicted SJF (default 0)
 */
 typedef struct {
   int num;
@@ -20,11 +33,15 @@ typedef struct {
 } sch_problem;
 
 /*
+  wait_total is the sum of the waits of all the jobs, exact even when
+  wait_average is rounded.
+
   Example 1:
   Consider First Come First Served and table in previous comment.
   num: 3
   *order: [2, 1, 3]
   wait_average: 3.333333
+  wait_total: 10
 
   Example 2:
   Consider Shortest Job First and table in previous comment.
@@ -47,6 +64,21 @@ typedef struct {
   wait_average: 2.500000
 
   Example 4:
+  Consider Lottery or Stride with quantum 2 and the following table:
+  -----------------------------------
+  | ID  | ARRIVAL | BURST | TICKETS |
+  -----------------------------------
+  |  1  |   0     |  4    |  1      |
+  |  2  |   0     |  4    |  3      |
+  -----------------------------------
+  Preemptive policies store in *order the order of completion and count
+  as wait every cycle a job spends ready but not running.
+  Stride:
+  num: 2
+  *order: [2, 1]
+  wait_average: 2.000000
+
+  Example 5:
   Consider FCFS or SJF, and the following table of jobs:
   -------------------------
   | ID  | ARRIVAL | BURST |
@@ -60,10 +92,629 @@ typedef struct {
   int num;
   int *order;
   float wait_average;
+  long long wait_total;
 } sch_solution;
 
+/*
+  Compact form of a scheduling problem, for instances too large to hold
+  one row per job. The jobs are sorted by ARRIVAL (then ID) and each one
+  is stored as three variable-length integers (1 to 5 bytes each):
+          ARRIVAL - ARRIVAL of the previous job
+          ID
+          BURST
+  Only FCFS and SJF can run on it. The optional columns are not stored.
+  num: number of jobs
+  size: number of bytes used in *data
+  capacity: number of bytes allocated for *data
+  last_arrival, last_id: last job appended, to check the order
+*/
+typedef struct {
+  int num;
+  long size;
+  long capacity;
+  unsigned char *data;
+  int last_arrival;
+  int last_id;
+} sch_packed_problem;
+
 void sch_table_malloc(sch_problem *sch);
 void sch_table_free  (sch_problem *sch);
 sch_problem  * sch_get_scheduling_problem_instance();
 sch_solution * sch_fcfs(sch_problem *sch);
 sch_solution * sch_sjf (sch_problem *sch);
+sch_solution * sch_lottery(sch_problem *sch, int quantum, unsigned int seed);
+sch_solution * sch_stride (sch_problem *sch, int quantum);
+sch_solution * sch_rr  (sch_problem *sch, int quantum);
+sch_solution * sch_mlfq(sch_problem *sch, int levels, int quantum);
+
+/*
+  Deadline analysis of an EDF solution. The arrays are aligned with the
+  order of completion in the solution, jobs with NO_DEADLINE are never
+  late and have a tardiness of 0.
+  num: number of jobs
+  *finish: cycle at which each job finished
+  *tardiness: max(0, finish - deadline) of each job
+  missed: number of jobs that missed their deadline
+  *missed_ids: IDs of those jobs, in order of completion
+  max_lateness: max of finish - deadline over the jobs with a deadline
+                (0 when no job has one)
+*/
+typedef struct {
+  int num;
+  long long *finish;
+  long long *tardiness;
+  int missed;
+  int *missed_ids;
+  long long max_lateness;
+} sch_deadline_report;
+
+sch_solution * sch_edf(sch_problem *sch, int preemptive, sch_deadline_report *report);
+void sch_deadline_report_free(sch_deadline_report *report);
+
+sch_packed_problem * sch_packed_malloc();
+void sch_packed_free  (sch_packed_problem *pk);
+int  sch_packed_append(sch_packed_problem *pk, int id, int arrival, int burst);
+sch_packed_problem * sch_pack(sch_problem *sch);
+sch_solution * sch_fcfs_packed(sch_packed_problem *pk);
+sch_solution * sch_sjf_packed (sch_packed_problem *pk);
+
+/*
+  Jobs alternating between CPU bursts and I/O bursts on devices.
+  The phases of job i are first_phase[i] .. first_phase[i+1]-1, each with
+  a length and the device it runs on (IO_CPU for a CPU burst).
+  Example, job 1 arrives at 0: CPU 3, disk 5, CPU 2
+           job 2 arrives at 1: CPU 1
+  num: 2, phases: 4, devices: 1
+  *id:           [1, 2]
+  *arrival:      [0, 1]
+  *first_phase:  [0, 3, 4]
+  *phase_length: [3, 5, 2, 1]
+  *phase_device: [IO_CPU, 0, IO_CPU, IO_CPU]
+*/
+#define IO_CPU -1
+
+typedef struct {
+  int num;
+  int phases;
+  int devices;
+  int *id;
+  int *arrival;
+  int *first_phase;
+  int *phase_length;
+  int *phase_device;
+} sch_io_problem;
+
+/*
+  Use of each resource by a schedule of a sch_io_problem. Resource 0 is
+  the CPU, resource d+1 is device d.
+  resources: devices + 1
+  *busy: cycles each resource was working
+  *wait: cycles jobs spent in the queue of each resource
+  *utilization: busy / makespan of each resource
+  makespan: cycle at which the last job finished
+*/
+typedef struct {
+  int resources;
+  long long *busy;
+  long long *wait;
+  float *utilization;
+  long long makespan;
+} sch_io_report;
+
+sch_io_problem * sch_io_problem_malloc(int num, int phases, int devices);
+void sch_io_problem_free(sch_io_problem *io);
+void sch_io_report_free (sch_io_report *report);
+sch_solution * sch_fcfs_io(sch_io_problem *io, sch_io_report *report);
+sch_solution * sch_sjf_io (sch_io_problem *io, sch_io_report *report);
+
+/*
+  Totals of a schedule whose jobs are not kept in memory.
+  num: number of jobs
+  wait_total: sum of the waits of all the jobs
+  wait_average: wait_total / num
+  makespan: cycle at which the last job finished
+*/
+typedef struct {
+  long long num;
+  long long wait_total;
+  float wait_average;
+  long long makespan;
+} sch_summary;
+
+/*
+  Trace files, for instances larger than the memory, hold one record per
+  job of three int in native byte order: ID, ARRIVAL, BURST. The records
+  can be in any order. The output of sch_external is a text file with one
+  line "ID START WAIT" per job, in the order the jobs run.
+*/
+int sch_trace_write(const char *path, sch_problem *sch);
+int sch_external(const char *trace, const char *output, int sort_by_burst,
+                 long memory, sch_summary *summary);
+
+/*
+  Buffers reused by sch_solve_jobs from one call to the next, for callers
+  solving many problems such as schedd.
+*/
+typedef struct sch_arena sch_arena;
+
+sch_arena * sch_arena_malloc();
+void sch_arena_free(sch_arena *arena);
+long long sch_solve_jobs(sch_arena *arena, int num, const int *jobs,
+                         int sort_by_burst, int *order);
+
+/*
+  Record of a job given by sch_stream and sch_stream_packed when it is
+  dispatched, instead of storing it in a solution.
+  wait: start - ARRIVAL
+  finish: start + BURST
+*/
+typedef struct {
+  int id;
+  long long start;
+  long long finish;
+  long long wait;
+} sch_dispatch_record;
+
+typedef void (*sch_record_callback)(void *ctx, const sch_dispatch_record *record);
+
+void sch_stream(sch_problem *sch, int sort_by_burst, sch_record_callback record,
+                void *ctx, sch_summary *summary);
+void sch_stream_packed(sch_packed_problem *pk, int sort_by_burst,
+                       sch_record_callback record, void *ctx, sch_summary *summary);
+
+/*
+  Writer of dispatch records to a file, filled by passing sch_writer_record
+  and the writer as callback to sch_stream. It fills one buffer while a
+  thread writes the other one, so the engine only waits for the disk when
+  it is faster than the disk for a whole buffer.
+  WRITER_BINARY: the records as sch_dispatch_record, in native layout
+  WRITER_CSV:    a line "id,start,finish,wait", then one line per record
+*/
+#define WRITER_BINARY 0
+#define WRITER_CSV    1
+
+typedef struct sch_writer sch_writer;
+
+sch_writer * sch_writer_open(const char *path, int format, int buffer_records);
+void sch_writer_record(void *writer, const sch_dispatch_record *record);
+int  sch_writer_close(sch_writer *writer);
+
+/*
+  Sampled simulation of a problem too large to simulate entirely. The
+  arrival span is cut into strata * windows time windows of the same
+  length, and samples windows of each stratum are simulated, each one
+  starting warmup cycles before the window with an empty queue to rebuild
+  the backlog carried into it. Only the waits of the jobs arriving in the
+  window are counted. More samples and a longer warm-up are slower and
+  more accurate; samples = windows with a warm-up covering the trace is
+  the exact result.
+  samples: windows simulated per stratum, at most windows (more are
+           ignored), and at least 2 to estimate the variance of the
+           stratum unless there is a single window
+  confidence: level of the interval, for example 0.95
+  seed: seed of the choice of the windows
+*/
+typedef struct {
+  int strata;
+  int windows;
+  int samples;
+  int warmup;
+  float confidence;
+  unsigned int seed;
+} sch_sample_config;
+
+/*
+  Estimate of the average wait by sch_sample.
+  ci_low, ci_high: confidence interval of wait_average
+  jobs_sampled: jobs of the sampled windows
+  jobs_simulated: jobs simulated, with the warm-ups and the jobs arriving
+                  before the last job of a window is dispatched
+*/
+typedef struct {
+  float wait_average;
+  float std_error;
+  float ci_low;
+  float ci_high;
+  long long jobs_sampled;
+  long long jobs_simulated;
+} sch_sample_report;
+
+int sch_sample(sch_problem *sch, int sort_by_burst, sch_sample_config *config,
+               sch_sample_report *report);
+
+/*
+  State of an FCFS or SJF schedule of a table sorted by arrival time, run
+  by steps: the current cycle, the index of the next row to read, the
+  totals and, for SJF, the ready jobs. It can be saved at any point and
+  loaded again to resume the schedule, or copied to fork it, in time
+  proportional to the number of ready jobs. A saved state must be run on
+  the same table.
+
+  Checkpoint files hold in native byte order: int magic, version,
+  sort_by_burst and number of ready jobs, long long cycle, next row,
+  dispatched jobs and total wait, then ID, ARRIVAL, BURST of each ready
+  job.
+*/
+typedef struct sch_engine sch_engine;
+
+sch_engine * sch_engine_malloc(int sort_by_burst);
+void sch_engine_free(sch_engine *eng);
+sch_engine * sch_engine_copy(sch_engine *eng);
+int  sch_engine_run(sch_engine *eng, sch_problem *sch, long long until,
+                    sch_record_callback record, void *ctx);
+void sch_engine_summary(sch_engine *eng, sch_summary *summary);
+int  sch_engine_save(sch_engine *eng, const char *path);
+sch_engine * sch_engine_load(const char *path);
+
+/*
+  Past bursts of each process, one after the other in contiguous arrays:
+  the bursts of process p, oldest first, are burst[first[p]] to
+  burst[first[p + 1] - 1].
+*/
+typedef struct {
+  int processes;
+  int *first;
+  int *burst;
+} sch_history;
+
+/*
+  Predicted SJF: the scheduler does not know BURST. The burst of a job is
+  predicted when it arrives as the estimate of its PROCESS, and the
+  estimate is updated with the real burst when the job finishes, by
+  exponential averaging: estimate = alpha * burst + (1 - alpha) * estimate.
+  initial: estimate of a process without history
+  preemptive: 0 for SJF, 1 for SRTF on the predicted remaining time
+*/
+typedef struct {
+  float alpha;
+  float initial;
+  int preemptive;
+} sch_predict_config;
+
+/*
+  Quality of the predictions, against the same policy knowing the bursts.
+  prediction_error: mean of |prediction - BURST| over the jobs
+  prediction_bias: mean of prediction - BURST over the jobs
+  oracle_wait_average: average wait of SJF (or SRTF) with the real bursts
+  wait_penalty: wait_average - oracle_wait_average
+*/
+typedef struct {
+  float wait_average;
+  float prediction_error;
+  float prediction_bias;
+  float oracle_wait_average;
+  float wait_penalty;
+} sch_predict_report;
+
+void sch_history_estimates(sch_history *history, float alpha, float initial,
+                           float *estimate);
+sch_solution * sch_sjf_predicted(sch_problem *sch, int processes, sch_history *history,
+                                 sch_predict_config *config, sch_predict_report *report);
+
+/*
+  Search of the quantum of RR (levels = 1) or of the first level of MLFQ
+  (sch_mlfq) minimizing the average wait (TUNE_WAIT) or the 99th
+  percentile of the response time, from arrival to first run
+  (TUNE_P99_RESPONSE). Every quantum min_quantum, min_quantum + step, ...
+  up to max_quantum is run, on threads threads.
+*/
+#define TUNE_WAIT         0
+#define TUNE_P99_RESPONSE 1
+
+typedef struct {
+  int levels;
+  int min_quantum;
+  int max_quantum;
+  int step;
+  int objective;
+  int threads;
+} sch_tune_config;
+
+/*
+  Result of sch_tune_quantum.
+  quantum: best quantum, the smallest one of the best score
+  score: its average wait, or its 99th percentile response time
+  evaluated: quanta run to the end
+  pruned: quanta stopped once they could not beat the best one
+*/
+typedef struct {
+  int quantum;
+  float score;
+  int evaluated;
+  int pruned;
+} sch_tune_report;
+
+int sch_tune_quantum(sch_problem *sch, sch_tune_config *config, sch_tune_report *report);
+
+/*
+  Many small problems in one structure of arrays, for sch_fcfs_batch. The
+  jobs of problem p are first[p] .. first[p+1]-1, in any order.
+  Example, problem 0: job 1 arrives at 2, burst 6; job 2 at 0, burst 3
+           problem 1: job 1 arrives at 0, burst 4
+  count: 2, jobs: 3
+  *first:   [0, 2, 3]
+  *id:      [1, 2, 1]
+  *arrival: [2, 0, 0]
+  *burst:   [6, 3, 4]
+*/
+typedef struct {
+  int count;
+  int jobs;
+  int *first;
+  int *id;
+  int *arrival;
+  int *burst;
+} sch_batch_problem;
+
+sch_batch_problem * sch_batch_problem_malloc(int count, int jobs);
+void sch_batch_problem_free(sch_batch_problem *batch);
+sch_batch_problem * sch_batch_pack(sch_problem **problems, int count);
+sch_solution * sch_fcfs_batch(sch_batch_problem *batch);
+void sch_batch_solutions_free(sch_solution *sols);
+
+/*
+  Placement policies on cores of different speeds. The speed of a core is
+  in percent of the single CPU of sch_fcfs: a job of BURST b runs for
+  ceil(b * 100 / speed) cycles on it.
+  PLACE_FASTEST:      FCFS, each job on the fastest idle core
+  PLACE_LEAST_LOADED: FCFS, each job on the idle core busy for the fewest
+                      cycles so far
+  PLACE_SJF_FAST:     SJF, each job on the fastest idle core
+  Ties between cores go to the lowest core index.
+*/
+#define PLACE_FASTEST      0
+#define PLACE_LEAST_LOADED 1
+#define PLACE_SJF_FAST     2
+
+/*
+  Use of each core by a schedule of sch_cores.
+  cores: number of cores
+  *jobs: number of jobs run on each core
+  *busy: cycles each core was working
+  *wait: sum of the waits of the jobs run on each core
+  *down: cycles of outage of each core before the makespan
+  *utilization: busy / makespan of each core
+  makespan: cycle at which the last job finished
+*/
+typedef struct {
+  int cores;
+  int *jobs;
+  long long *busy;
+  long long *wait;
+  long long *down;
+  float *utilization;
+  long long makespan;
+} sch_core_report;
+
+sch_solution * sch_cores(sch_problem *sch, int cores, int *speed, int placement,
+                         sch_core_report *report);
+void sch_core_report_free(sch_core_report *report);
+
+/*
+  Outages of the cores: cycles [start, end) during which a core cannot
+  run jobs, for maintenance or reserved periods. The outages of core c,
+  sorted and not overlapping, are start[first[c]] .. start[first[c+1]-1].
+  Example, core 0 down from 2 to 5 and from 9 to 10, core 1 always up
+  cores: 2, intervals: 2
+  *first: [0, 2, 2]
+  *start: [2, 9]
+  *end:   [5, 10]
+
+  What happens to a job that would run during an outage:
+  OUTAGE_DEFER:  it does not start before the first time its core is up
+                 for its whole length, the core waits for it
+  OUTAGE_RESUME: it starts as soon as its core is up, stops during the
+                 outages and resumes after them; the time it is stopped
+                 counts as wait
+*/
+#define OUTAGE_DEFER  0
+#define OUTAGE_RESUME 1
+
+typedef struct {
+  int cores;
+  int intervals;
+  int *first;
+  long long *start;
+  long long *end;
+} sch_outages;
+
+sch_outages * sch_outages_from_intervals(int cores, int count, int *core,
+                                         long long *start, long long *end);
+void sch_outages_free(sch_outages *outages);
+sch_solution * sch_cores_outages(sch_problem *sch, int cores, int *speed, int placement,
+                                 sch_outages *outages, int policy,
+                                 sch_core_report *report);
+
+/*
+  Dependencies between the jobs of a problem, in compressed sparse row
+  form. Node i is the row sch->table[i] when the DAG is built, and its
+  children, the jobs that cannot start before it finished, are
+  child[first[i]] .. child[first[i+1]-1].
+  Example, with jobs in rows 0, 1, 2: 0 -> 1, 0 -> 2, 1 -> 2
+  num: 3, edges: 3
+  *first: [0, 2, 3, 3]
+  *child: [1, 2, 2]
+*/
+typedef struct {
+  int num;
+  int edges;
+  int *first;
+  int *child;
+} sch_dag;
+
+/*
+  Policies choosing among the jobs whose parents all finished:
+  DAG_FCFS:          lowest ready time, when the job arrived and all its
+                     parents finished
+  DAG_SJF:           lowest BURST
+  DAG_CRITICAL_PATH: longest path of BURST from the job to the end of
+                     the DAG
+  Ties go to the lowest ID.
+*/
+#define DAG_FCFS          0
+#define DAG_SJF           1
+#define DAG_CRITICAL_PATH 2
+
+/*
+  makespan: cycle at which the last job finished
+  critical_path: sum of the BURST of the longest chain of dependencies
+*/
+typedef struct {
+  long long makespan;
+  long long critical_path;
+} sch_dag_report;
+
+sch_dag * sch_dag_from_edges(int num, int edges, int *parent, int *child);
+void sch_dag_free(sch_dag *dag);
+sch_solution * sch_dag_schedule(sch_problem *sch, sch_dag *dag, int policy,
+                                sch_dag_report *report);
+
+/*
+  Analytic estimate of the waits of FCFS and SJF, from summary statistics
+  of the jobs instead of a simulation. Arrivals are taken as a Poisson
+  process over the span of the table: FCFS uses the Pollaczek-Khinchine
+  formula of the M/G/1 queue, SJF the non pre-emptive priority formula
+  with the jobs grouped by powers of two of BURST. When the load is 1 or
+  more, the waits come from the growth of the backlog over the span, and
+  when all the jobs arrive at once, from the work queued before each.
+  arrival_rate: jobs per cycle
+  burst_mean, burst_m2: mean of BURST and of BURST^2
+  load: arrival_rate * burst_mean
+  span: last ARRIVAL - first ARRIVAL
+  wait_fcfs, wait_sjf: estimated average waits
+  error_fcfs, error_sjf: |estimate - exact| / exact, set by
+                         sch_estimate_error (0 when exact is 0)
+*/
+typedef struct {
+  int num;
+  double arrival_rate;
+  double burst_mean;
+  double burst_m2;
+  double load;
+  long long span;
+  float wait_fcfs;
+  float wait_sjf;
+  float error_fcfs;
+  float error_sjf;
+} sch_estimate;
+
+void sch_estimate_waits(sch_problem *sch, sch_estimate *est);
+void sch_estimate_error(sch_problem *sch, sch_estimate *est);
+
+/*
+  Live execution of a schedule: each job runs for real on a pool of
+  worker threads, for BURST cycles of cycle_ns nanoseconds, released at
+  ARRIVAL cycles after the start.
+  workers: number of worker threads
+  cycle_ns: length of one cycle in nanoseconds
+  busy_wait: 1 to spin on the CPU for the burst, 0 to sleep
+*/
+typedef struct {
+  int workers;
+  long cycle_ns;
+  int busy_wait;
+} sch_live_config;
+
+/*
+  Measures of a live execution, compared with the simulation of the same
+  policy on as many cores of speed 100 as workers (sch_cores).
+  num: number of jobs
+  *order: order in which the jobs started
+  wait_average: measured average wait, in cycles
+  simulated_wait_average: average wait of the simulation, in cycles
+  latency_average, latency_max: time from the choice of a job by the
+                                dispatcher to its start on a worker, in ns
+  jitter: standard deviation of that latency, in ns
+*/
+typedef struct {
+  int num;
+  int *order;
+  double wait_average;
+  double simulated_wait_average;
+  double latency_average;
+  long long latency_max;
+  double jitter;
+} sch_live_report;
+
+int  sch_live(sch_problem *sch, int sort_by_burst, sch_live_config *config,
+              sch_live_report *report);
+void sch_live_report_free(sch_live_report *report);
+
+/*
+  FCFS or SJF with a ready queue of at most capacity jobs, for overload.
+  A job arriving when the queue is full is handled by the policy:
+  ADMIT_REJECT:       the arriving job is dropped
+  ADMIT_DROP_LONGEST: the job of the longest BURST among the queued ones
+                      and the arriving one is dropped, the latest one on
+                      ties
+  ADMIT_DROP_OLDEST:  the job queued the longest is dropped
+  The jobs arriving at the cycle the CPU becomes free are queued before
+  the next job is chosen, as in sch_fcfs and sch_sjf: with a capacity of
+  at least the number of jobs, nothing is dropped and the schedule is the
+  same.
+*/
+#define ADMIT_REJECT       0
+#define ADMIT_DROP_LONGEST 1
+#define ADMIT_DROP_OLDEST  2
+
+typedef struct {
+  int capacity;
+  int policy;
+} sch_admission_config;
+
+/*
+  Record of a dropped job, given to a sch_drop_callback.
+  time: cycle at which it was dropped, the arrival of the job that did
+        not fit in the queue
+*/
+typedef struct {
+  int id;
+  int arrival;
+  int burst;
+  long long time;
+} sch_drop_record;
+
+typedef void (*sch_drop_callback)(void *ctx, const sch_drop_record *record);
+
+/*
+  Source of jobs generated on demand, sorted by ARRIVAL then ID: stores
+  the next job and returns 1, or returns 0 at the end. Like the rows of a
+  table, the jobs have int arrivals, so a generator must stop before its
+  arrivals pass INT_MAX.
+*/
+typedef int (*sch_job_generator)(void *ctx, int *id, int *arrival, int *burst);
+
+/*
+  Result of an execution with admission control. The waits are those of
+  the admitted jobs, which all run to the end.
+  drop_rate: dropped / arrived
+  goodput: admitted jobs finished per cycle, admitted / makespan
+  *wait_histogram: number of waits of 0 in bucket 0, and of waits from
+                   2^(b-1) to 2^b - 1 in bucket b
+  wait_p50, wait_p99: percentiles of the wait, interpolated in the
+                      histogram
+  queue_max: longest the queue has been
+*/
+#define ADMIT_WAIT_BUCKETS 64
+
+typedef struct {
+  long long arrived;
+  long long admitted;
+  long long dropped;
+  float drop_rate;
+  float goodput;
+  long long wait_total;
+  float wait_average;
+  long long wait_max;
+  float wait_p50;
+  float wait_p99;
+  long long wait_histogram[ADMIT_WAIT_BUCKETS];
+  long long makespan;
+  int queue_max;
+} sch_admission_report;
+
+int sch_admit(sch_problem *sch, int sort_by_burst, sch_admission_config *config,
+              sch_drop_callback drop, void *ctx, sch_admission_report *report);
+int sch_admit_generated(sch_job_generator next, void *next_ctx, int sort_by_burst,
+                        sch_admission_config *config, sch_drop_callback drop,
+                        void *ctx, sch_admission_report *report);
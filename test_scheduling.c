@@ -2,7 +2,9 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <limits.h>
 
 #define VERBOSE 1
 
@@ -30,6 +32,25 @@ void test9();
 void test10();
 void test11();
 void test12();
+void test13();
+void test14();
+void test15();
+void test16();
+void test17();
+void test18();
+void test19();
+void test20();
+void test21();
+void test22();
+void test23();
+void test24();
+void test25();
+void test26();
+void test27();
+void test28();
+void test29();
+void test30();
+void test31();
 
 void manualTest();
 
@@ -48,6 +69,25 @@ int main() {
   test10();
   test11();
   test12();
+  test13();
+  test14();
+  test15();
+  test16();
+  test17();
+  test18();
+  test19();
+  test20();
+  test21();
+  test22();
+  test23();
+  test24();
+  test25();
+  test26();
+  test27();
+  test28();
+  test29();
+  test30();
+  test31();
 
   //manualTest();
 }
@@ -125,6 +165,64 @@ void check_sjf(sch_problem *sch, sch_solution *expected_sjf) {
   free(expected_sjf);  
 }
 
+void check_lottery(sch_problem *sch, int quantum, unsigned int seed, sch_solution *expected_lottery) {
+  print_message("lottery", W_ALGO);
+  sch_solution * sol_lottery = sch_lottery(sch, quantum, seed);
+  if (VERBOSE) print_solution(*sol_lottery);
+  solution_check_equals(*sol_lottery, *expected_lottery);
+  free(sol_lottery->order);
+  free(sol_lottery);
+  free(expected_lottery->order);
+  free(expected_lottery);
+}
+
+void check_stride(sch_problem *sch, int quantum, sch_solution *expected_stride) {
+  print_message("stride", W_ALGO);
+  sch_solution * sol_stride = sch_stride(sch, quantum);
+  if (VERBOSE) print_solution(*sol_stride);
+  solution_check_equals(*sol_stride, *expected_stride);
+  free(sol_stride->order);
+  free(sol_stride);
+  free(expected_stride->order);
+  free(expected_stride);
+}
+
+void check_packed(sch_packed_problem *pk, sch_solution *expected_fcfs, sch_solution *expected_sjf) {
+  print_message("fcfs packed", W_ALGO);
+  sch_solution * sol_fcfs = sch_fcfs_packed(pk);
+  if (VERBOSE) print_solution(*sol_fcfs);
+  solution_check_equals(*sol_fcfs, *expected_fcfs);
+  print_message("sjf packed", W_ALGO);
+  sch_solution * sol_sjf = sch_sjf_packed(pk);
+  if (VERBOSE) print_solution(*sol_sjf);
+  solution_check_equals(*sol_sjf, *expected_sjf);
+  free(sol_fcfs->order);
+  free(sol_fcfs);
+  free(sol_sjf->order);
+  free(sol_sjf);
+}
+
+void check_edf(sch_problem *sch, int preemptive, sch_solution *expected_edf,
+               int missed, int *missed_ids, long long max_lateness) {
+  print_message(preemptive ? "edf pre-emptive" : "edf", W_ALGO);
+  sch_deadline_report report;
+  sch_solution * sol_edf = sch_edf(sch, preemptive, &report);
+  if (VERBOSE) print_solution(*sol_edf);
+  solution_check_equals(*sol_edf, *expected_edf);
+  if (report.missed != missed ||
+      !check_order(report.missed_ids, missed_ids, missed) ||
+      report.max_lateness != max_lateness) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  sch_deadline_report_free(&report);
+  free(sol_edf->order);
+  free(sol_edf);
+  free(expected_edf->order);
+  free(expected_edf);
+}
+
 
 /*
  *
@@ -660,6 +758,1330 @@ void test12() {
   free(sch);
 }
 
+void test13() {
+  print_message("Test 13", W_TEST);
+  // scheduling problem instance
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 3;
+  sch_table_malloc(sch);
+  sch->table[0][ID] = 1;
+  sch->table[0][ARRIVAL] = 0;
+  sch->table[0][BURST] = 4;
+  sch->table[0][TICKETS] = 1;
+  sch->table[1][ID] = 2;
+  sch->table[1][ARRIVAL] = 0;
+  sch->table[1][BURST] = 4;
+  sch->table[1][TICKETS] = 3;
+  sch->table[2][ID] = 3;
+  sch->table[2][ARRIVAL] = 20;
+  sch->table[2][BURST] = 0;
+  sch->table[2][TICKETS] = 2;
+  // expected stride solution instance
+  sch_solution *expected_stride = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_stride->num = 3;
+  expected_stride->order = (int*) malloc(3 * sizeof(int));
+  expected_stride->order[0] = 2;
+  expected_stride->order[1] = 1;
+  expected_stride->order[2] = 3;
+  expected_stride->wait_average = 4.0 / 3;
+  // expected lottery solution instance with quantum 1 and seed 42: the
+  // draws of rng_next from 42 give job 2 its 4 cycles first (3 tickets
+  // out of 4), job 1 waits 4 and job 3 arrives after both
+  sch_solution *expected_lottery = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_lottery->num = 3;
+  expected_lottery->order = (int*) malloc(3 * sizeof(int));
+  expected_lottery->order[0] = 2;
+  expected_lottery->order[1] = 1;
+  expected_lottery->order[2] = 3;
+  expected_lottery->wait_average = 4.0 / 3;
+
+  // check (and free memory solutions)
+  check_stride(sch, 2, expected_stride);
+  check_lottery(sch, 1, 42, expected_lottery);
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test14() {
+  print_message("Test 14", W_TEST);
+  // scheduling problem instance, a quantum as long as the bursts and no
+  // overlapping jobs leave a single ticket holder at each draw
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 3;
+  sch_table_malloc(sch);
+  sch->table[0][ID] = 1;
+  sch->table[0][ARRIVAL] = 6;
+  sch->table[0][BURST] = 3;
+  sch->table[0][TICKETS] = 5;
+  sch->table[1][ID] = 2;
+  sch->table[1][ARRIVAL] = 0;
+  sch->table[1][BURST] = 2;
+  sch->table[1][TICKETS] = 1;
+  sch->table[2][ID] = 3;
+  sch->table[2][ARRIVAL] = 2;
+  sch->table[2][BURST] = 4;
+  sch->table[2][TICKETS] = 0;
+  // expected lottery solution instance
+  sch_solution *expected_lottery = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_lottery->num = 3;
+  expected_lottery->order = (int*) malloc(3 * sizeof(int));
+  expected_lottery->order[0] = 2;
+  expected_lottery->order[1] = 3;
+  expected_lottery->order[2] = 1;
+  expected_lottery->wait_average = 0.0;
+  // expected stride solution instance
+  sch_solution *expected_stride = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_stride->num = 3;
+  expected_stride->order = (int*) malloc(3 * sizeof(int));
+  expected_stride->order[0] = 2;
+  expected_stride->order[1] = 3;
+  expected_stride->order[2] = 1;
+  expected_stride->wait_average = 0.0;
+
+  // check (and free memory solutions)
+  check_lottery(sch, 4, 7, expected_lottery);
+  check_stride(sch, 4, expected_stride);
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test15() {
+  print_message("Test 15", W_TEST);
+  // scheduling problem instance, the one of test 5 plus a zero burst job
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 6;
+  sch_table_malloc(sch);
+  sch->table[0][ID] = 1;
+  sch->table[0][ARRIVAL] = 2;
+  sch->table[0][BURST] = 6;
+  sch->table[1][ID] = 2;
+  sch->table[1][ARRIVAL] = 5;
+  sch->table[1][BURST] = 2;
+  sch->table[2][ID] = 3;
+  sch->table[2][ARRIVAL] = 1;
+  sch->table[2][BURST] = 8;
+  sch->table[3][ID] = 4;
+  sch->table[3][ARRIVAL] = 0;
+  sch->table[3][BURST] = 3;
+  sch->table[4][ID] = 5;
+  sch->table[4][ARRIVAL] = 4;
+  sch->table[4][BURST] = 4;
+  sch->table[5][ID] = 300;
+  sch->table[5][ARRIVAL] = 200;
+  sch->table[5][BURST] = 0;
+  sch_packed_problem *pk = sch_pack(sch);
+  // jobs out of order are refused
+  if (sch_packed_append(pk, 1, 100, 1)) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  // jobs before cycle 0 are refused, arrivals up to INT_MAX are kept
+  sch_packed_problem *far = sch_packed_malloc();
+  int refused = !sch_packed_append(far, 1, -1, 1);
+  sch_packed_append(far, 1, 0, 1);
+  sch_packed_append(far, 2, 2000000000, 1);
+  sch_packed_append(far, 3, 2147483646, 1);
+  sch_solution *far_fcfs = sch_fcfs_packed(far);
+  if (!refused || far->num != 3 || far_fcfs->wait_average != 0.0 || far_fcfs->order[2] != 3) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  free(far_fcfs->order);
+  free(far_fcfs);
+  sch_packed_free(far);
+  // the packed and the plain problem give the same solutions
+  sch_solution *expected_fcfs = sch_fcfs(sch);
+  sch_solution *expected_sjf = sch_sjf(sch);
+
+  // check
+  check_packed(pk, expected_fcfs, expected_sjf);
+
+  // free
+  free(expected_fcfs->order);
+  free(expected_fcfs);
+  free(expected_sjf->order);
+  free(expected_sjf);
+  sch_packed_free(pk);
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test16() {
+  print_message("Test 16", W_TEST);
+  // scheduling problem instance
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 4;
+  sch_table_malloc(sch);
+  sch->table[0][ID] = 1;
+  sch->table[0][ARRIVAL] = 0;
+  sch->table[0][BURST] = 4;
+  sch->table[0][DEADLINE] = 10;
+  sch->table[1][ID] = 2;
+  sch->table[1][ARRIVAL] = 1;
+  sch->table[1][BURST] = 2;
+  sch->table[1][DEADLINE] = 4;
+  sch->table[2][ID] = 3;
+  sch->table[2][ARRIVAL] = 2;
+  sch->table[2][BURST] = 1;
+  sch->table[2][DEADLINE] = 3;
+  sch->table[3][ID] = 4;
+  sch->table[3][ARRIVAL] = 30;
+  sch->table[3][BURST] = 0;
+  // expected edf solution instance
+  sch_solution *expected_edf = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_edf->num = 4;
+  expected_edf->order = (int*) malloc(4 * sizeof(int));
+  expected_edf->order[0] = 1;
+  expected_edf->order[1] = 3;
+  expected_edf->order[2] = 2;
+  expected_edf->order[3] = 4;
+  expected_edf->wait_average = 1.5;
+  int missed_edf[] = {3, 2};
+  // expected pre-emptive edf solution instance
+  sch_solution *expected_edf_p = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_edf_p->num = 4;
+  expected_edf_p->order = (int*) malloc(4 * sizeof(int));
+  expected_edf_p->order[0] = 3;
+  expected_edf_p->order[1] = 2;
+  expected_edf_p->order[2] = 1;
+  expected_edf_p->order[3] = 4;
+  expected_edf_p->wait_average = 1.0;
+
+  // check (and free memory solutions)
+  check_edf(sch, 0, expected_edf, 2, missed_edf, 3);
+  check_edf(sch, 1, expected_edf_p, 0, NULL, 0);
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test17() {
+  print_message("Test 17", W_TEST);
+  // jobs with I/O bursts: 1 arrives at 0 with CPU 3, disk 5, CPU 2
+  //                       2 arrives at 1 with CPU 1
+  //                       3 arrives at 2 with disk 4, CPU 1
+  sch_io_problem *io = sch_io_problem_malloc(3, 6, 1);
+  int phase_length[] = {3, 5, 2, 1, 4, 1};
+  int phase_device[] = {IO_CPU, 0, IO_CPU, IO_CPU, 0, IO_CPU};
+  io->id[0] = 1;
+  io->arrival[0] = 0;
+  io->first_phase[1] = 3;
+  io->id[1] = 2;
+  io->arrival[1] = 1;
+  io->first_phase[2] = 4;
+  io->id[2] = 3;
+  io->arrival[2] = 2;
+  io->first_phase[3] = 6;
+  for (int i = 0; i < 6; i++) {
+    io->phase_length[i] = phase_length[i];
+    io->phase_device[i] = phase_device[i];
+  }
+  // expected fcfs solution instance: 3 uses the disk from 2 to 6 and the
+  // CPU from 6 to 7, 1 waits for the disk from 3 to 6 and ends at 13
+  sch_solution *expected_fcfs = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_fcfs->num = 3;
+  expected_fcfs->order = (int*) malloc(3 * sizeof(int));
+  expected_fcfs->order[0] = 2;
+  expected_fcfs->order[1] = 3;
+  expected_fcfs->order[2] = 1;
+  expected_fcfs->wait_average = 2.0 / 3;
+
+  print_message("fcfs i/o", W_ALGO);
+  sch_io_report report;
+  sch_solution *sol_fcfs = sch_fcfs_io(io, &report);
+  if (VERBOSE) print_solution(*sol_fcfs);
+  solution_check_equals(*sol_fcfs, *expected_fcfs);
+  if (report.resources != 2 || report.makespan != 13 ||
+      report.busy[0] != 7 || report.busy[1] != 9 ||
+      report.wait[0] != 2 || report.wait[1] != 3) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  sch_io_report_free(&report);
+  free(sol_fcfs->order);
+  free(sol_fcfs);
+  free(expected_fcfs->order);
+  free(expected_fcfs);
+  sch_io_problem_free(io);
+
+  // with only CPU bursts the solutions are the ones of sch_fcfs and sch_sjf
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 5};
+  int burst[] = {6, 2, 8, 0, 2};
+  io = sch_io_problem_malloc(5, 5, 0);
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+    io->id[i] = i + 1;
+    io->arrival[i] = arrival[i];
+    io->first_phase[i + 1] = i + 1;
+    io->phase_length[i] = burst[i];
+    io->phase_device[i] = IO_CPU;
+  }
+  expected_fcfs = sch_fcfs(sch);
+  sch_solution *expected_sjf = sch_sjf(sch);
+  print_message("fcfs i/o", W_ALGO);
+  sol_fcfs = sch_fcfs_io(io, NULL);
+  solution_check_equals(*sol_fcfs, *expected_fcfs);
+  print_message("sjf i/o", W_ALGO);
+  sch_solution *sol_sjf = sch_sjf_io(io, NULL);
+  solution_check_equals(*sol_sjf, *expected_sjf);
+
+  // a phase on a device the problem does not have is refused
+  print_message("i/o bad device", W_ALGO);
+  io->phase_device[2] = 0;
+  if (sch_fcfs_io(io, NULL) != NULL || sch_sjf_io(io, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  free(sol_fcfs->order);
+  free(sol_fcfs);
+  free(sol_sjf->order);
+  free(sol_sjf);
+  free(expected_fcfs->order);
+  free(expected_fcfs);
+  free(expected_sjf->order);
+  free(expected_sjf);
+  sch_io_problem_free(io);
+  sch_table_free(sch);
+  free(sch);
+}
+
+void check_external(char *trace, int sort_by_burst, sch_solution *expected) {
+  print_message(sort_by_burst ? "sjf external" : "fcfs external", W_ALGO);
+  sch_summary summary;
+  int ok = sch_external(trace, "test_external.txt", sort_by_burst, 60, &summary);
+  FILE *in = fopen("test_external.txt", "r");
+  int id = 0;
+  long long start = 0, wait = 0;
+  for (int i = 0; ok && i < expected->num; i++) {
+    ok = fscanf(in, "%d %lld %lld", &id, &start, &wait) == 3 && id == expected->order[i];
+  }
+  fclose(in);
+  remove("test_external.txt");
+  if (ok && summary.num == expected->num && summary.wait_total == expected->wait_total &&
+      summary.wait_average == expected->wait_average) {
+    print_message("pass", W_PASS);
+  } else {
+    print_message("FAIL", W_FAIL);
+  }
+  free(expected->order);
+  free(expected);
+}
+
+void test18() {
+  print_message("Test 18", W_TEST);
+  // scheduling problem instance, sorted in 3 runs of 16 jobs by sch_external,
+  // merged two at a time before the last merge
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 40;
+  sch_table_malloc(sch);
+  for (int i = 0; i < 40; i++) {
+    sch->table[i][ID] = 40 - i;
+    sch->table[i][ARRIVAL] = (i * 7) % 13 * 3;
+    sch->table[i][BURST] = (i * 5) % 4;
+  }
+  sch_trace_write("test_trace.bin", sch);
+  // expected solutions from the reference
+  sch_solution *expected_fcfs = sch_fcfs(sch);
+  sch_solution *expected_sjf = sch_sjf(sch);
+
+  // check (and free memory solutions)
+  check_external("test_trace.bin", 0, expected_fcfs);
+  check_external("test_trace.bin", 1, expected_sjf);
+
+  // free
+  remove("test_trace.bin");
+  sch_table_free(sch);
+  free(sch);
+}
+
+void check_cores(sch_problem *sch, int cores, int *speed, int placement, sch_solution *expected) {
+  print_message(placement == PLACE_SJF_FAST ? "cores sjf" : "cores fcfs", W_ALGO);
+  sch_solution *sol = sch_cores(sch, cores, speed, placement, NULL);
+  if (VERBOSE) print_solution(*sol);
+  solution_check_equals(*sol, *expected);
+  free(sol->order);
+  free(sol);
+  free(expected->order);
+  free(expected);
+}
+
+void test19() {
+  print_message("Test 19", W_TEST);
+  // scheduling problem instance
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 4;
+  sch_table_malloc(sch);
+  sch->table[0][ID] = 1;
+  sch->table[0][ARRIVAL] = 0;
+  sch->table[0][BURST] = 4;
+  sch->table[1][ID] = 2;
+  sch->table[1][ARRIVAL] = 0;
+  sch->table[1][BURST] = 4;
+  sch->table[2][ID] = 3;
+  sch->table[2][ARRIVAL] = 1;
+  sch->table[2][BURST] = 2;
+  sch->table[3][ID] = 4;
+  sch->table[3][ARRIVAL] = 2;
+  sch->table[3][BURST] = 1;
+  int speed[] = {100, 200};
+  // expected solution on the fastest core, core 1 runs 1, 3 and 4
+  sch_solution *expected_fast = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_fast->num = 4;
+  expected_fast->order = (int*) malloc(4 * sizeof(int));
+  expected_fast->order[0] = 1;
+  expected_fast->order[1] = 2;
+  expected_fast->order[2] = 3;
+  expected_fast->order[3] = 4;
+  expected_fast->wait_average = 0.5;
+  // expected sjf solution on the fastest core
+  sch_solution *expected_sjf = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_sjf->num = 4;
+  expected_sjf->order = (int*) malloc(4 * sizeof(int));
+  expected_sjf->order[0] = 1;
+  expected_sjf->order[1] = 2;
+  expected_sjf->order[2] = 4;
+  expected_sjf->order[3] = 3;
+  expected_sjf->wait_average = 0.5;
+
+  print_message("cores report", W_ALGO);
+  sch_core_report report;
+  sch_solution *sol = sch_cores(sch, 2, speed, PLACE_FASTEST, &report);
+  if (report.makespan != 4 || report.jobs[0] != 1 || report.jobs[1] != 3 ||
+      report.busy[0] != 4 || report.busy[1] != 4 ||
+      report.wait[0] != 0 || report.wait[1] != 2 || report.utilization[1] != 1.0) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  sch_core_report_free(&report);
+  free(sol->order);
+  free(sol);
+
+  // check (and free memory solutions)
+  check_cores(sch, 2, speed, PLACE_FASTEST, expected_fast);
+  check_cores(sch, 2, speed, PLACE_SJF_FAST, expected_sjf);
+
+  // no core, no speeds or a stopped core are refused
+  print_message("cores invalid", W_ALGO);
+  int stopped[2] = { 100, 0 };
+  if (sch_cores(sch, 0, speed, PLACE_FASTEST, NULL) != NULL ||
+      sch_cores(sch, 2, NULL, PLACE_FASTEST, NULL) != NULL ||
+      sch_cores(sch, 2, stopped, PLACE_FASTEST, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void check_dag(sch_problem *sch, sch_dag *dag, int policy, sch_solution *expected) {
+  print_message(policy == DAG_FCFS ? "dag fcfs" : policy == DAG_SJF ? "dag sjf" : "dag critical path", W_ALGO);
+  sch_dag_report report;
+  sch_solution *sol = sch_dag_schedule(sch, dag, policy, &report);
+  if (VERBOSE) print_solution(*sol);
+  if (solution_check_equals(*sol, *expected)) {
+    if (report.makespan != 12 || report.critical_path != 7) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+  free(sol->order);
+  free(sol);
+  free(expected->order);
+  free(expected);
+}
+
+void test20() {
+  print_message("Test 20", W_TEST);
+  // scheduling problem instance, 1 -> 2 -> 4 and 1 -> 3 -> 4, 5 alone
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int burst[] = {2, 3, 1, 2, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = 0;
+    sch->table[i][BURST] = burst[i];
+  }
+  int parent[] = {0, 0, 1, 2};
+  int child[] = {1, 2, 3, 3};
+  sch_dag *dag = sch_dag_from_edges(5, 4, parent, child);
+  // expected fcfs solution instance
+  sch_solution *expected_fcfs = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_fcfs->num = 5;
+  expected_fcfs->order = (int*) malloc(5 * sizeof(int));
+  expected_fcfs->order[0] = 1;
+  expected_fcfs->order[1] = 5;
+  expected_fcfs->order[2] = 2;
+  expected_fcfs->order[3] = 3;
+  expected_fcfs->order[4] = 4;
+  expected_fcfs->wait_average = 2.6;
+  // expected sjf solution instance
+  sch_solution *expected_sjf = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_sjf->num = 5;
+  expected_sjf->order = (int*) malloc(5 * sizeof(int));
+  expected_sjf->order[0] = 1;
+  expected_sjf->order[1] = 3;
+  expected_sjf->order[2] = 2;
+  expected_sjf->order[3] = 4;
+  expected_sjf->order[4] = 5;
+  expected_sjf->wait_average = 1.8;
+  // expected critical path solution instance
+  sch_solution *expected_cp = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_cp->num = 5;
+  expected_cp->order = (int*) malloc(5 * sizeof(int));
+  expected_cp->order[0] = 1;
+  expected_cp->order[1] = 2;
+  expected_cp->order[2] = 5;
+  expected_cp->order[3] = 3;
+  expected_cp->order[4] = 4;
+  expected_cp->wait_average = 2.4;
+
+  // check (and free memory solutions)
+  check_dag(sch, dag, DAG_FCFS, expected_fcfs);
+  check_dag(sch, dag, DAG_SJF, expected_sjf);
+  check_dag(sch, dag, DAG_CRITICAL_PATH, expected_cp);
+
+  // a cycle has no solution
+  print_message("dag cycle", W_ALGO);
+  int cycle_parent[] = {0, 1};
+  int cycle_child[] = {1, 0};
+  sch_dag *cycle = sch_dag_from_edges(5, 2, cycle_parent, cycle_child);
+  if (sch_dag_schedule(sch, cycle, DAG_FCFS, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // an edge out of the rows, or a DAG of fewer jobs, is refused
+  print_message("dag invalid", W_ALGO);
+  int bad_parent[] = {0, 7};
+  int bad_child[] = {1, 1};
+  sch_dag *small = sch_dag_from_edges(3, 1, cycle_parent, cycle_child);
+  if (sch_dag_from_edges(3, 2, bad_parent, bad_child) != NULL ||
+      sch_dag_from_edges(3, 1, bad_child, bad_parent + 1) != NULL ||
+      sch_dag_schedule(sch, small, DAG_FCFS, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_dag_free(small);
+  sch_dag_free(cycle);
+  sch_dag_free(dag);
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test21() {
+  print_message("Test 21", W_TEST);
+  // scheduling problem instance of test 6, a single batch
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 4;
+  sch_table_malloc(sch);
+  int burst[] = {6, 8, 7, 3};
+  for (int i = 0; i < 4; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = 0;
+    sch->table[i][BURST] = burst[i];
+  }
+
+  // estimate, then error against the exact waits 10.25 and 7.0
+  print_message("estimate", W_ALGO);
+  sch_estimate est;
+  sch_estimate_waits(sch, &est);
+  sch_estimate_error(sch, &est);
+  if (VERBOSE) printf("Estimated waits %f %f, errors %f %f\n",
+                      est.wait_fcfs, est.wait_sjf, est.error_fcfs, est.error_sjf);
+  if (est.span != 0 || est.load != 0.0 ||
+      est.wait_fcfs != 9.0 || est.wait_sjf != 7.125 ||
+      fabsf(est.error_fcfs - 1.25f / 10.25f) > 0.00001 ||
+      fabsf(est.error_sjf - 0.125f / 7.0f) > 0.00001) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test22() {
+  print_message("Test 22", W_TEST);
+  // scheduling problem instance of test 5, run for real with 2 ms cycles
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+  int expected_fcfs[] = {4, 3, 1, 5, 2};
+  int expected_sjf[] = {4, 1, 2, 5, 3};
+  sch_live_config config = { 1, 2000000, 0 };
+
+  // the order is exact; the measured waits cannot be much shorter than the
+  // simulated ones, since the jobs sleep at least their bursts, and are
+  // only checked loosely above them, delays depending on the load
+  for (int sjf = 0; sjf <= 1; sjf++) {
+    print_message(sjf ? "sjf live" : "fcfs live", W_ALGO);
+    sch_live_report report;
+    int ok = sch_live(sch, sjf, &config, &report);
+    if (VERBOSE) printf("Measured wait %f, simulated %f, latency %f ns, jitter %f ns\n",
+      report.wait_average, report.simulated_wait_average, report.latency_average, report.jitter);
+    if (!ok || !check_order(report.order, sjf ? expected_sjf : expected_fcfs, 5) ||
+        report.simulated_wait_average != (sjf ? 5.2f : 8.0f) ||
+        report.wait_average < report.simulated_wait_average - 0.25 ||
+        report.wait_average > report.simulated_wait_average * 1.5 + 2.0) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+    sch_live_report_free(&report);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test23() {
+  print_message("Test 23", W_TEST);
+  // instances of test 5 and test 6 as flat arrays, solved with one arena
+  int jobs5[] = {1, 2, 6,  2, 5, 2,  3, 1, 8,  4, 0, 3,  5, 4, 4};
+  int jobs6[] = {1, 0, 6,  2, 0, 8,  3, 0, 7,  4, 0, 3};
+  int expected5_fcfs[] = {4, 3, 1, 5, 2};
+  int expected5_sjf[] = {4, 1, 2, 5, 3};
+  int expected6_fcfs[] = {1, 2, 3, 4};
+  int expected6_sjf[] = {4, 1, 3, 2};
+  int order[5];
+  sch_arena *arena = sch_arena_malloc();
+
+  for (int round = 0; round < 2; round++) {
+    for (int sjf = 0; sjf <= 1; sjf++) {
+      print_message(sjf ? "sjf flat" : "fcfs flat", W_ALGO);
+      long long wait5 = sch_solve_jobs(arena, 5, jobs5, sjf, order);
+      int ok5 = check_order(order, sjf ? expected5_sjf : expected5_fcfs, 5);
+      long long wait6 = sch_solve_jobs(arena, 4, jobs6, sjf, order);
+      int ok6 = check_order(order, sjf ? expected6_sjf : expected6_fcfs, 4);
+      if (!ok5 || !ok6 || wait5 != (sjf ? 26 : 40) || wait6 != (sjf ? 28 : 41)) {
+        print_message("FAIL", W_FAIL);
+      } else {
+        print_message("pass", W_PASS);
+      }
+    }
+  }
+
+  // free
+  sch_arena_free(arena);
+}
+
+void collect_record(void *ctx, const sch_dispatch_record *record) {
+  sch_dispatch_record **next = (sch_dispatch_record**) ctx;
+  *(*next)++ = *record;
+}
+
+void test24() {
+  print_message("Test 24", W_TEST);
+  // scheduling problem instance of test 5
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+  // expected sjf records: id, start, finish, wait
+  sch_dispatch_record expected[] = {
+    {4, 0, 3, 0}, {1, 3, 9, 1}, {2, 9, 11, 4}, {5, 11, 15, 7}, {3, 15, 23, 14}
+  };
+
+  // records given to a callback
+  print_message("sjf stream", W_ALGO);
+  sch_dispatch_record records[5];
+  sch_dispatch_record *next = records;
+  sch_summary summary;
+  sch_stream(sch, 1, collect_record, &next, &summary);
+  int ok = next == records + 5 && summary.num == 5 && summary.wait_total == 26 &&
+           summary.wait_average == 5.2f && summary.makespan == 23;
+  for (int i = 0; ok && i < 5; i++) {
+    ok = records[i].id == expected[i].id && records[i].start == expected[i].start &&
+         records[i].finish == expected[i].finish && records[i].wait == expected[i].wait;
+  }
+  if (!ok) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // records written to files, with buffers of 2 records
+  print_message("sjf stream to binary", W_ALGO);
+  sch_writer *wr = sch_writer_open("test_records.bin", WRITER_BINARY, 2);
+  sch_stream(sch, 1, sch_writer_record, wr, &summary);
+  ok = sch_writer_close(wr);
+  FILE *in = fopen("test_records.bin", "rb");
+  ok &= fread(records, sizeof(sch_dispatch_record), 5, in) == 5 && fgetc(in) == EOF;
+  fclose(in);
+  for (int i = 0; ok && i < 5; i++) {
+    ok = records[i].id == expected[i].id && records[i].start == expected[i].start &&
+         records[i].finish == expected[i].finish && records[i].wait == expected[i].wait;
+  }
+  if (!ok) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  print_message("sjf stream to csv", W_ALGO);
+  wr = sch_writer_open("test_records.csv", WRITER_CSV, 2);
+  sch_stream(sch, 1, sch_writer_record, wr, &summary);
+  ok = sch_writer_close(wr);
+  in = fopen("test_records.csv", "r");
+  char header[64];
+  ok &= fscanf(in, "%63s", header) == 1 && strcmp(header, "id,start,finish,wait") == 0;
+  for (int i = 0; ok && i < 5; i++) {
+    int id;
+    long long start, finish, wait;
+    ok = fscanf(in, "%d,%lld,%lld,%lld", &id, &start, &finish, &wait) == 4 &&
+         id == expected[i].id && start == expected[i].start &&
+         finish == expected[i].finish && wait == expected[i].wait;
+  }
+  fclose(in);
+  if (!ok) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  remove("test_records.bin");
+  remove("test_records.csv");
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test25() {
+  print_message("Test 25", W_TEST);
+  // scheduling problem instance of test 5, sorted by arrival time
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int id[] = {4, 3, 1, 5, 2};
+  int arrival[] = {0, 1, 2, 4, 5};
+  int burst[] = {3, 8, 6, 4, 2};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = id[i];
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+
+  // every window with a warm-up from the start: the exact waits 8.0 and 5.2
+  sch_sample_config config = { 2, 3, 3, 10, 0.95f, 1 };
+  for (int sjf = 0; sjf <= 1; sjf++) {
+    print_message(sjf ? "sjf all windows" : "fcfs all windows", W_ALGO);
+    sch_sample_report report;
+    int ok = sch_sample(sch, sjf, &config, &report);
+    if (!ok || report.wait_average != (sjf ? 5.2f : 8.0f) || report.std_error != 0.0f ||
+        report.ci_low != report.ci_high || report.jobs_sampled != 5) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+
+  // without warm-up the backlog is lost: the estimate is lower
+  print_message("fcfs no warm-up", W_ALGO);
+  config.warmup = 0;
+  sch_sample_report report;
+  sch_sample(sch, 0, &config, &report);
+  if (report.wait_average >= 8.0f) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // a single sample of several windows has no variance: refused
+  print_message("sample invalid", W_ALGO);
+  config.samples = 1;
+  if (sch_sample(sch, 0, &config, &report)) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test26() {
+  print_message("Test 26", W_TEST);
+  // scheduling problem instance of test 5, sorted by arrival time
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int id[] = {4, 3, 1, 5, 2};
+  int arrival[] = {0, 1, 2, 4, 5};
+  int burst[] = {3, 8, 6, 4, 2};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = id[i];
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+  int expected_fcfs[] = {4, 3, 1, 5, 2};
+  int expected_sjf[] = {4, 1, 2, 5, 3};
+
+  // run to cycle 10, checkpoint, then finish the run and the restored copy
+  for (int sjf = 0; sjf <= 1; sjf++) {
+    print_message(sjf ? "sjf checkpoint" : "fcfs checkpoint", W_ALGO);
+    int order[5], resumed[5];
+    sch_dispatch_record records[5];
+    sch_dispatch_record *next = records;
+    sch_engine *eng = sch_engine_malloc(sjf);
+    int remains = sch_engine_run(eng, sch, 10, collect_record, &next);
+    int done = next - records;
+    int saved = sch_engine_save(eng, "test_checkpoint.bin");
+    remains &= !sch_engine_run(eng, sch, -1, collect_record, &next);
+    for (int i = 0; i < 5; i++)
+      order[i] = records[i].id;
+    sch_summary summary, restored_summary;
+    sch_engine_summary(eng, &summary);
+    sch_engine_free(eng);
+
+    eng = sch_engine_load("test_checkpoint.bin");
+    next = records;
+    sch_engine_run(eng, sch, -1, collect_record, &next);
+    for (int i = 0; i < 5 - done; i++)
+      resumed[i] = records[i].id;
+    sch_engine_summary(eng, &restored_summary);
+    sch_engine_free(eng);
+
+    if (!remains || !saved || done != (sjf ? 3 : 2) || next != records + 5 - done ||
+        !check_order(order, sjf ? expected_sjf : expected_fcfs, 5) ||
+        !check_order(resumed, order + done, 5 - done) ||
+        summary.wait_total != (sjf ? 26 : 40) ||
+        restored_summary.wait_total != summary.wait_total ||
+        restored_summary.makespan != 23) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+
+  // an SJF checkpoint with ready jobs, turned into FCFS or an unknown policy
+  print_message("bad checkpoint policy", W_ALGO);
+  sch_engine *eng = sch_engine_malloc(1);
+  sch_engine_run(eng, sch, 10, NULL, NULL);
+  sch_summary partial;
+  sch_engine_summary(eng, &partial);
+  sch_engine_save(eng, "test_checkpoint.bin");
+  sch_engine_free(eng);
+  int refused = 1;
+  for (int policy = 0; policy <= 2; policy += 2) {
+    FILE *file = fopen("test_checkpoint.bin", "r+b");
+    fseek(file, 2 * sizeof(int), SEEK_SET);
+    fwrite(&policy, sizeof(int), 1, file);
+    fclose(file);
+    refused &= sch_engine_load("test_checkpoint.bin") == NULL;
+  }
+  if (partial.num != 3 || !refused) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // not a checkpoint
+  print_message("bad checkpoint", W_ALGO);
+  FILE *out = fopen("test_checkpoint.bin", "wb");
+  fprintf(out, "not a checkpoint");
+  fclose(out);
+  if (sch_engine_load("test_checkpoint.bin") != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  remove("test_checkpoint.bin");
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test27() {
+  print_message("Test 27", W_TEST);
+  // scheduling problem instance of test 5, jobs 1, 2, 5 of process 0
+  // and jobs 3, 4 of process 1
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  int process[] = {0, 0, 1, 1, 0};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+    sch->table[i][PROCESS] = process[i];
+  }
+  // past bursts 6, 6 of process 0 and 2, 2 of process 1
+  int first[] = {0, 2, 4};
+  int past[] = {6, 6, 2, 2};
+  sch_history history = { 2, first, past };
+  sch_predict_config config = { 0.5f, 5.0f, 0 };
+
+  // estimates 0.25 * 5 + 0.25 * 6 + 0.5 * 6 and 0.25 * 5 + 0.25 * 2 + 0.5 * 2
+  print_message("history estimates", W_ALGO);
+  float estimate[2];
+  sch_history_estimates(&history, config.alpha, config.initial, estimate);
+  if (estimate[0] != 5.75f || estimate[1] != 2.75f) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // job 3 is predicted short from the history of process 1
+  int expected[] = {4, 3, 1, 2, 5};
+  for (int srtf = 0; srtf <= 1; srtf++) {
+    print_message(srtf ? "srtf predicted" : "sjf predicted", W_ALGO);
+    config.preemptive = srtf;
+    sch_predict_report report;
+    sch_solution *sol = sch_sjf_predicted(sch, 2, &history, &config, &report);
+    if (VERBOSE) printf("Wait %f, oracle %f, error %f, bias %f\n", report.wait_average,
+                        report.oracle_wait_average, report.prediction_error, report.prediction_bias);
+    if (!check_order(sol->order, expected, 5) || sol->wait_total != 38 ||
+        report.oracle_wait_average != (srtf ? 4.6f : 5.2f) ||
+        fabsf(report.wait_penalty - (srtf ? 3.0f : 2.4f)) > 0.00001 ||
+        fabsf(report.prediction_error - (srtf ? 2.25f : 2.225f)) > 0.00001 ||
+        fabsf(report.prediction_bias - (srtf ? -0.05f : -0.025f)) > 0.00001) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+    free(sol->order);
+    free(sol);
+  }
+
+  // 9 past bursts of process 0: the partial sums give the recurrence
+  print_message("long history estimates", W_ALGO);
+  int long_first[] = {0, 9, 9};
+  int long_past[] = {4, 8, 2, 6, 10, 1, 3, 7, 5};
+  sch_history long_history = { 2, long_first, long_past };
+  sch_history_estimates(&long_history, config.alpha, config.initial, estimate);
+  float recurrence = config.initial;
+  for (int j = 0; j < 9; j++)
+    recurrence = config.alpha * long_past[j] + (1.0f - config.alpha) * recurrence;
+  if (fabsf(estimate[0] - recurrence) > 0.0001f || estimate[1] != config.initial) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // a PROCESS without history slot is refused
+  print_message("predicted bad process", W_ALGO);
+  sch->table[2][PROCESS] = 2;
+  if (sch_sjf_predicted(sch, 2, &history, &config, NULL) != NULL ||
+      sch_sjf_predicted(sch, 1, NULL, &config, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void check_mlfq(sch_problem *sch, int levels, int quantum, sch_solution *expected) {
+  print_message(levels > 1 ? "mlfq" : "rr", W_ALGO);
+  sch_solution *sol = sch_mlfq(sch, levels, quantum);
+  if (VERBOSE) print_solution(*sol);
+  solution_check_equals(*sol, *expected);
+  free(sol->order);
+  free(sol);
+  free(expected->order);
+  free(expected);
+}
+
+void test28() {
+  print_message("Test 28", W_TEST);
+  // scheduling problem instance of test 5
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+  // expected rr solution instance, quantum 2
+  sch_solution *expected_rr = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_rr->num = 5;
+  expected_rr->order = (int*) malloc(5 * sizeof(int));
+  expected_rr->order[0] = 4;
+  expected_rr->order[1] = 2;
+  expected_rr->order[2] = 5;
+  expected_rr->order[3] = 1;
+  expected_rr->order[4] = 3;
+  expected_rr->wait_average = 9.2;
+  // expected mlfq solution instance, 2 levels of quantum 2 and 4
+  sch_solution *expected_mlfq = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_mlfq->num = 5;
+  expected_mlfq->order = (int*) malloc(5 * sizeof(int));
+  expected_mlfq->order[0] = 2;
+  expected_mlfq->order[1] = 4;
+  expected_mlfq->order[2] = 1;
+  expected_mlfq->order[3] = 5;
+  expected_mlfq->order[4] = 3;
+  expected_mlfq->wait_average = 9.8;
+
+  // check (and free memory solutions)
+  check_mlfq(sch, 1, 2, expected_rr);
+  check_mlfq(sch, 2, 2, expected_mlfq);
+
+  // the tuner finds the best of every quantum run one by one, on any
+  // number of threads
+  for (int threads = 1; threads <= 3; threads += 2) {
+    print_message(threads > 1 ? "tune rr, 3 threads" : "tune rr", W_ALGO);
+    sch_tune_config config = { 1, 1, 10, 1, TUNE_WAIT, threads };
+    sch_tune_report report;
+    int ok = sch_tune_quantum(sch, &config, &report);
+    int best = 0;
+    float best_wait = 0.0;
+    for (int quantum = 1; quantum <= 10; quantum++) {
+      sch_solution *sol = sch_rr(sch, quantum);
+      if (best == 0 || sol->wait_average < best_wait) {
+        best = quantum;
+        best_wait = sol->wait_average;
+      }
+      free(sol->order);
+      free(sol);
+    }
+    if (VERBOSE) printf("Best quantum %d, wait %f, %d evaluated, %d pruned\n",
+                        report.quantum, report.score, report.evaluated, report.pruned);
+    if (!ok || report.quantum != best || report.score != best_wait ||
+        report.evaluated + report.pruned != 10) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+
+  // the first runs of quantum 1 are the soonest: responses 0 0 0 0 1
+  print_message("tune p99 response", W_ALGO);
+  sch_tune_config config = { 2, 1, 10, 3, TUNE_P99_RESPONSE, 2 };
+  sch_tune_report report;
+  sch_tune_quantum(sch, &config, &report);
+  if (report.quantum != 1 || report.score != 1.0f) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
+void test29() {
+  print_message("Test 29", W_TEST);
+  // instances of test 5 and test 6, then an empty problem, a problem of
+  // 40 jobs and a problem finishing after INT_MAX, 20 times: more
+  // problems than SIMD lanes
+  int arrival5[] = {2, 5, 1, 0, 4}, burst5[] = {6, 2, 8, 3, 4};
+  int arrival6[] = {0, 0, 0, 0}, burst6[] = {6, 8, 7, 3};
+  int count = 100, num[] = {5, 4, 0, 40, 2};
+  sch_batch_problem *batch = sch_batch_problem_malloc(count, 20 * 51);
+  sch_problem **problems = (sch_problem**) malloc(sizeof(sch_problem*) * count);
+  int j = 0;
+  for (int p = 0; p < count; p++) {
+    sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+    sch->num = num[p % 5];
+    sch_table_malloc(sch);
+    for (int i = 0; i < sch->num; i++, j++) {
+      int a = 0, b = 0;
+      switch (p % 5) {
+      case 0: a = arrival5[i]; b = burst5[i]; break;
+      case 1: a = arrival6[i]; b = burst6[i]; break;
+      case 3: a = (i * 7 + p) % 50; b = (i * 3 + p) % 5; break;
+      case 4: a = INT_MAX - 4; b = 5; break;
+      }
+      // IDs backwards: the ties of test 6 run in the order 1 2 3 4 of
+      // bursts 3 7 8 6, a wait of 31
+      batch->id[j] = sch->table[i][ID] = sch->num - i;
+      batch->arrival[j] = sch->table[i][ARRIVAL] = a;
+      batch->burst[j] = sch->table[i][BURST] = b;
+    }
+    batch->first[p + 1] = j;
+    problems[p] = sch;
+  }
+
+  print_message("fcfs batch", W_ALGO);
+  sch_solution *sols = sch_fcfs_batch(batch);
+  int ok = 1, expected4[] = {1, 2};
+  for (int p = 0; p < count; p++) {
+    // sch_fcfs would run the INT_MAX ticks before the jobs
+    if (p % 5 == 4) {
+      ok &= sols[p].wait_total == 5 && check_order(sols[p].order, expected4, 2);
+      continue;
+    }
+    sch_solution *sol = sch_fcfs(problems[p]);
+    ok &= sols[p].num == sol->num && sols[p].wait_total == sol->wait_total &&
+          sols[p].wait_average == sol->wait_average &&
+          check_order(sols[p].order, sol->order, sol->num);
+    free(sol->order);
+    free(sol);
+  }
+  if (!ok || sols[0].wait_total != 40 || sols[1].wait_total != 31) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_batch_solutions_free(sols);
+  sch_batch_problem_free(batch);
+  for (int p = 0; p < count; p++) {
+    sch_table_free(problems[p]);
+    free(problems[p]);
+  }
+  free(problems);
+}
+
+void check_outages(sch_problem *sch, sch_outages *outages, int policy,
+                   sch_solution *expected, long long makespan, long long down) {
+  print_message(policy == OUTAGE_DEFER ? "outages defer" : "outages resume", W_ALGO);
+  int speed = 100;
+  sch_core_report report;
+  sch_solution *sol = sch_cores_outages(sch, 1, &speed, PLACE_FASTEST, outages, policy, &report);
+  if (VERBOSE) print_solution(*sol);
+  if (solution_check_equals(*sol, *expected)) {
+    if (report.makespan != makespan || report.down[0] != down || report.busy[0] != 23) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+  sch_core_report_free(&report);
+  free(sol->order);
+  free(sol);
+  free(expected->order);
+  free(expected);
+}
+
+void test30() {
+  print_message("Test 30", W_TEST);
+  // scheduling problem instance of test 5
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+  // the CPU is down from 3 to 7 and from 12 to 14, the last two outages
+  // are empty or of no core
+  int core[] = {0, 0, 0, 0, 0, 1};
+  long long start[] = {12, 4, 3, 6, 9, 0};
+  long long end[] = {14, 6, 5, 7, 9, 100};
+  sch_outages *outages = sch_outages_from_intervals(1, 6, core, start, end);
+  print_message("outages merged", W_ALGO);
+  if (outages->intervals != 2 || outages->first[1] != 2 ||
+      outages->start[0] != 3 || outages->end[0] != 7 ||
+      outages->start[1] != 12 || outages->end[1] != 14) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+  // expected solution deferring job 3 until 14: waits 0 13 20 24 27
+  sch_solution *expected_defer = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_defer->num = 5;
+  expected_defer->order = (int*) malloc(5 * sizeof(int));
+  expected_defer->order[0] = 4;
+  expected_defer->order[1] = 3;
+  expected_defer->order[2] = 1;
+  expected_defer->order[3] = 5;
+  expected_defer->order[4] = 2;
+  expected_defer->wait_average = 16.8;
+  // expected solution running job 3 from 7 to 12 and from 14 to 17:
+  // waits 0 8 15 19 22
+  sch_solution *expected_resume = (sch_solution*) malloc(sizeof(sch_solution));
+  expected_resume->num = 5;
+  expected_resume->order = (int*) malloc(5 * sizeof(int));
+  expected_resume->order[0] = 4;
+  expected_resume->order[1] = 3;
+  expected_resume->order[2] = 1;
+  expected_resume->order[3] = 5;
+  expected_resume->order[4] = 2;
+  expected_resume->wait_average = 12.8;
+
+  // check (and free memory solutions)
+  check_outages(sch, outages, OUTAGE_DEFER, expected_defer, 34, 6);
+  check_outages(sch, outages, OUTAGE_RESUME, expected_resume, 29, 6);
+
+  // the outages of one core for two cores are refused
+  print_message("outages bad cores", W_ALGO);
+  int speeds[2] = { 100, 100 };
+  if (sch_cores_outages(sch, 2, speeds, PLACE_FASTEST, outages, OUTAGE_DEFER, NULL) != NULL) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_outages_free(outages);
+  sch_table_free(sch);
+  free(sch);
+}
+
+void collect_drop(void *ctx, const sch_drop_record *record) {
+  sch_drop_record **next = (sch_drop_record**) ctx;
+  *(*next)++ = *record;
+}
+
+void check_admit(sch_problem *sch, int sort_by_burst, int policy, int dropped_id,
+                 long long wait_total, long long makespan) {
+  print_message(policy == ADMIT_REJECT ? "admit reject" :
+                policy == ADMIT_DROP_OLDEST ? "admit drop oldest" : "admit drop longest", W_ALGO);
+  sch_admission_config config = { 2, policy };
+  sch_admission_report report;
+  sch_drop_record drops[5], *next = drops;
+  int ok = sch_admit(sch, sort_by_burst, &config, collect_drop, &next, &report);
+  if (VERBOSE) printf("Wait %lld, makespan %lld, p50 %f, p99 %f\n", report.wait_total,
+                      report.makespan, report.wait_p50, report.wait_p99);
+  if (!ok || next != drops + 1 || drops[0].id != dropped_id || drops[0].time != 5 ||
+      report.arrived != 5 || report.admitted != 4 || report.dropped != 1 ||
+      report.drop_rate != 0.2f || report.wait_total != wait_total ||
+      report.makespan != makespan || report.goodput != (float) (4.0 / makespan) ||
+      report.queue_max != 2) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+}
+
+int overload_next(void *ctx, int *id, int *arrival, int *burst) {
+  int *i = (int*) ctx;
+  if (*i == 1000)
+    return 0;
+  *id = *i + 1;
+  *arrival = *i;
+  *burst = 1 + *i % 3;
+  (*i)++;
+  return 1;
+}
+
+void test31() {
+  print_message("Test 31", W_TEST);
+  // scheduling problem instance of test 5
+  sch_problem *sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 5;
+  sch_table_malloc(sch);
+  int arrival[] = {2, 5, 1, 0, 4};
+  int burst[] = {6, 2, 8, 3, 4};
+  for (int i = 0; i < 5; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = arrival[i];
+    sch->table[i][BURST] = burst[i];
+  }
+
+  // queue of 2, full when job 2 arrives at 5: FCFS has 1 and 5 queued
+  // waits 0 2 9 13 without 2, 0 2 7 10 without 1
+  check_admit(sch, 0, ADMIT_REJECT, 2, 24, 21);
+  check_admit(sch, 0, ADMIT_DROP_OLDEST, 1, 19, 17);
+  // SJF runs 1 before 3, then drops 3: waits 0 1 4 7
+  check_admit(sch, 1, ADMIT_DROP_LONGEST, 3, 12, 15);
+
+  print_message("admit distribution", W_ALGO);
+  sch_admission_config config = { 2, ADMIT_REJECT };
+  sch_admission_report report;
+  sch_admit(sch, 0, &config, NULL, NULL, &report);
+  if (report.wait_histogram[0] != 1 || report.wait_histogram[2] != 1 ||
+      report.wait_histogram[4] != 2 || report.wait_max != 13 ||
+      report.wait_p99 != 13.0f || report.wait_average != 6.0f) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // the queue holds all the jobs: nothing is dropped
+  print_message("admit all", W_ALGO);
+  config.capacity = 5;
+  sch_admit(sch, 1, &config, NULL, NULL, &report);
+  if (report.dropped != 0 || report.wait_total != 26) {
+    print_message("FAIL", W_FAIL);
+  } else {
+    print_message("pass", W_PASS);
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+
+  // overloaded queue of generated jobs, the same as from a table
+  sch = (sch_problem*) malloc(sizeof(sch_problem));
+  sch->num = 1000;
+  sch_table_malloc(sch);
+  for (int i = 0; i < 1000; i++) {
+    sch->table[i][ID] = i + 1;
+    sch->table[i][ARRIVAL] = i;
+    sch->table[i][BURST] = 1 + i % 3;
+  }
+  for (int policy = ADMIT_REJECT; policy <= ADMIT_DROP_OLDEST; policy++) {
+    print_message("admit generated", W_ALGO);
+    sch_admission_config overload = { 8, policy };
+    sch_admission_report expected;
+    sch_admit(sch, policy == ADMIT_DROP_LONGEST, &overload, NULL, NULL, &expected);
+    int i = 0;
+    sch_admit_generated(overload_next, &i, policy == ADMIT_DROP_LONGEST, &overload,
+                        NULL, NULL, &report);
+    if (report.dropped == 0 || report.queue_max != 8 ||
+        report.admitted + report.dropped != 1000 ||
+        report.dropped != expected.dropped || report.wait_total != expected.wait_total ||
+        report.makespan != expected.makespan) {
+      print_message("FAIL", W_FAIL);
+    } else {
+      print_message("pass", W_PASS);
+    }
+  }
+
+  // free
+  sch_table_free(sch);
+  free(sch);
+}
+
 void manualTest() {
   print_message("Manual test", W_ALGO);
   sch_problem *sch = sch_get_scheduling_problem_instance();